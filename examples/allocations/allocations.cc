@@ -0,0 +1,289 @@
+#define MOCK_CELERITY
+// the tracing of the mock accessors allocates per access
+#define MOCK_CELERITY_QUIET
+#include "../../src/algorithm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <streambuf>
+#include <vector>
+
+// Counts heap allocations per iteration of repeatedly submitted, prepared pipelines and compares
+// them with hand-written command groups doing the same work. The queue itself allocates per
+// submission (so does the mock, see the empty command group for its baseline), the library must
+// not add a single allocation to that: every pipeline has to match its hand-written version exactly.
+// Algorithms that deliver a result through a future or use scratch buffers (reduce_many, histogram,
+// spmv) are not covered.
+
+using namespace celerity;
+
+constexpr auto DEMO_DATA_SIZE = 4;
+constexpr auto ITERATIONS = 64;
+constexpr auto MAX_ROUNDS = 16;
+
+std::atomic<long> allocations{ 0 };
+
+void* allocate(std::size_t n)
+{
+	++allocations;
+
+	if (const auto p = std::malloc(n ? n : 1)) return p;
+	throw std::bad_alloc{};
+}
+
+void* allocate(std::size_t n, std::align_val_t alignment)
+{
+	++allocations;
+
+	// aligned_alloc requires a non-zero multiple of the alignment
+	const auto a = static_cast<std::size_t>(alignment);
+	if (const auto p = std::aligned_alloc(a, (std::max<std::size_t>(n, 1) + a - 1) / a * a)) return p;
+	throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t n) { return allocate(n); }
+void* operator new[](std::size_t n) { return allocate(n); }
+void* operator new(std::size_t n, std::align_val_t a) { return allocate(n, a); }
+void* operator new[](std::size_t n, std::align_val_t a) { return allocate(n, a); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// discards everything the mock prints
+class null_buffer : public std::streambuf
+{
+protected:
+	int overflow(int c) override { return c; }
+};
+
+// spans the whole buffer along dimension dim, like the accesses of a slice
+struct slice_range_mapper
+{
+	size_t dim;
+	int size;
+
+	subrange<1> operator()(chunk<1> chnk) const
+	{
+		subrange<1> sr{ chnk.offset, chnk.range };
+		sr.offset[dim] = 0;
+		sr.range[dim] = size;
+		return sr;
+	}
+};
+
+struct measurement
+{
+	const char* pipeline;
+	double library;
+	double hand;
+};
+
+// Allocations per iteration in steady state. Pools and containers of the runtime grow during the
+// first rounds, so rounds of ITERATIONS are repeated until two of them allocate the same whole
+// number per iteration; NAN if that does not happen within MAX_ROUNDS.
+template<typename F>
+double allocations_per_iteration(distr_queue& q, const F& f)
+{
+	auto previous = -1.0;
+
+	for (auto round = 0; round < MAX_ROUNDS; ++round)
+	{
+		q.wait();
+		const long before = allocations;
+
+		for (auto i = 0; i < ITERATIONS; ++i) f();
+		q.wait();
+
+		const auto current = static_cast<double>(allocations - before) / ITERATIONS;
+
+		if (current == previous && current == std::floor(current)) return current;
+
+		previous = current;
+	}
+
+	return NAN;
+}
+
+int main(int argc, char* argv[]) {
+	auto verification_passed = true;
+
+	try {
+		// worker threads allocate depending on scheduling, execute every command group on submission
+#ifdef _WIN32
+		_putenv_s("MOCK_CELERITY_WORKERS", "0");
+#else
+		setenv("MOCK_CELERITY_WORKERS", "0", 1);
+#endif
+
+		distr_queue queue;
+
+		null_buffer null;
+		auto* const out = std::cout.rdbuf(&null);
+
+		const cl::sycl::range<1> r{ DEMO_DATA_SIZE };
+		buffer<float, 1> a{ r }, b{ r };
+
+		algorithm::fill(algorithm::distr<class init_a>(queue), begin(a), end(a), 1.f);
+
+		// submissions of empty command groups: what the queue allocates per submission on its own
+
+		const auto baseline = allocations_per_iteration(queue, [&]() { queue.submit([](handler) {}); });
+
+		std::vector<measurement> results;
+
+		// 1. prepared task
+
+		const auto scale = algorithm::actions::transform(algorithm::distr<class scale>(queue), begin(a), end(a), begin(b), [](float x) { return 2 * x; });
+
+		results.push_back({ "task",
+			allocations_per_iteration(queue, [&]() { scale | algorithm::submit_to(queue); }),
+			allocations_per_iteration(queue, [&]()
+				{
+					queue.submit([=](handler cgh)
+						{
+							auto r_a = a.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+							auto w_b = b.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+
+							cgh.parallel_for<class scale_hand>(r, [&](cl::sycl::item<1> item) { w_b[item] = 2 * r_a[item]; });
+						});
+				}) });
+
+		// 2. prepared task reading slices
+
+		const auto first = algorithm::actions::transform(algorithm::distr<class first>(queue), begin(a), end(a), begin(b), [](algorithm::slice<float, 1> s) { return s[0]; }, 0);
+
+		results.push_back({ "slice",
+			allocations_per_iteration(queue, [&]() { first | algorithm::submit_to(queue); }),
+			allocations_per_iteration(queue, [&]()
+				{
+					queue.submit([=](handler cgh)
+						{
+							auto r_a = a.get_access<access_mode::read>(cgh, slice_range_mapper{ 0, DEMO_DATA_SIZE });
+							auto w_b = b.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+
+							cgh.parallel_for<class first_hand>(r, [&](cl::sycl::item<1> item) { w_b[item] = r_a[{ 0 }]; });
+						});
+				}) });
+
+		// 3. prepared sequence of two tasks
+
+		const auto pipeline = algorithm::actions::fill(algorithm::distr<class refill>(queue), begin(b), end(b), 1.f)
+			| algorithm::actions::transform(algorithm::distr<class shift>(queue), begin(b), end(b), begin(a), [](float x) { return x + 1; });
+
+		results.push_back({ "sequence",
+			allocations_per_iteration(queue, [&]() { pipeline | algorithm::submit_to(queue); }),
+			allocations_per_iteration(queue, [&]()
+				{
+					queue.submit([=](handler cgh)
+						{
+							auto w_b = b.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+							cgh.parallel_for<class refill_hand>(r, [&](cl::sycl::item<1> item) { w_b[item] = 1.f; });
+						});
+
+					queue.submit([=](handler cgh)
+						{
+							auto r_b = b.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+							auto w_a = a.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+							cgh.parallel_for<class shift_hand>(r, [&](cl::sycl::item<1> item) { w_a[item] = r_b[item] + 1; });
+						});
+				}) });
+
+		// 4. task graph replayed with a parameter bound per iteration
+
+		const algorithm::parameter<float> factor{ 1.f };
+
+		const auto graph = algorithm::record(queue, [&](distr_queue q)
+			{
+				algorithm::transform(algorithm::distr<class replayed>(q), begin(a), end(a), begin(b), [factor](float x) { return factor.get() * x; });
+			});
+
+		// replays skip the prepass of the mock, so does the hand-written version through the mock's submission of recorded accesses
+		const auto replayed_hand = [=](float f)
+		{
+			return [=](handler cgh)
+			{
+				auto r_a = a.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+				auto w_b = b.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+
+				cgh.parallel_for<class replayed_hand>(r, [&](cl::sycl::item<1> item) { w_b[item] = f * r_a[item]; });
+			};
+		};
+
+		const auto replayed_hand_accesses = detail::runtime::instance().record(replayed_hand(0.f));
+
+		auto i = 0.f;
+
+		results.push_back({ "replay",
+			allocations_per_iteration(queue, [&]() { graph.replay(queue, factor.bind(++i)); }),
+			allocations_per_iteration(queue, [&]() { queue.submit(replayed_hand(++i), replayed_hand_accesses); }) });
+
+		// 5. prepared task split by a strategy, the hand-written version hands the mock the same split hint
+
+		const auto strategy = std::make_shared<algorithm::weighted_split>(std::vector<double>{ 3, 1 });
+		const auto hint = algorithm::detail::make_split_handle(strategy, algorithm::kernel_id_of<class split_scale>());
+
+		const auto split_scale = algorithm::actions::transform(algorithm::distr<class split_scale>(queue, strategy), begin(a), end(a), begin(b), [](float x) { return 2 * x; });
+
+		results.push_back({ "split",
+			allocations_per_iteration(queue, [&]() { split_scale | algorithm::submit_to(queue); }),
+			allocations_per_iteration(queue, [&]()
+				{
+					queue.submit([=](handler cgh)
+						{
+							cgh.split = hint;
+
+							auto r_a = a.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+							auto w_b = b.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+
+							cgh.parallel_for<class split_scale_hand>(r, [&](cl::sycl::item<1> item) { w_b[item] = 2 * r_a[item]; });
+						});
+				}) });
+
+		std::cout.rdbuf(out);
+
+		std::cout << "queue baseline: " << baseline << " allocations per submission" << std::endl;
+		std::cout << std::left << std::setw(10) << "pipeline" << std::right << std::setw(10) << "library" << std::setw(10) << "hand" << std::setw(10) << "delta" << std::endl;
+
+		verification_passed = !std::isnan(baseline);
+
+		for (const auto& m : results)
+		{
+			// NAN (no steady state) never compares equal
+			const auto passed = m.library == m.hand;
+
+			std::cout << std::left << std::setw(10) << m.pipeline << std::right << std::setw(10) << m.library << std::setw(10) << m.hand
+				<< std::setw(10) << m.library - m.hand << (passed ? "" : "  REGRESSION") << std::endl;
+
+			verification_passed = verification_passed && passed;
+		}
+
+		std::cout << "## RESULT: ";
+		if (verification_passed) {
+			std::cout << "Success! The library adds no allocations per iteration." << std::endl;
+		}
+		else {
+			std::cout << "Fail! The library allocates per iteration." << std::endl;
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	catch (cl::sycl::exception& e) {
+		std::cerr << "SYCL Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return verification_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -8,8 +8,28 @@
 #include "../../src/kernel_traits.h"
 #include "../../src/static_iterator.h"
 #include "../../src/algorithm.h"
-
+#include "../../src/sort.h"
+#include "../../src/matrix.h"
+#include "../../src/soa.h"
+#include "../../src/encoding.h"
+#include "../../src/histogram.h"
+#include "../../src/sparse.h"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -87,6 +107,40 @@ void sequence_static_assertions()
 	static_assert(algorithm::detail::get_accessor_type<algorithm::iterator<float, 1>, 0>() == access_type::invalid, "get_accessor_type");
 }
 
+// counts copies of a kernel, composition and submission have to move actions through
+struct counted_kernel
+{
+	static inline int copies = 0;
+
+	counted_kernel() = default;
+	counted_kernel(const counted_kernel&) { ++copies; }
+	counted_kernel(counted_kernel&&) noexcept = default;
+
+	void operator()(celerity::handler) const {}
+};
+
+bool composition_copy_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	counted_kernel::copies = 0;
+
+	auto fused = fuse(counted_kernel{} | counted_kernel{} | counted_kernel{} | counted_kernel{});
+	task(counted_kernel{}) | std::move(fused) | counted_kernel{} | submit_to(q);
+
+	// move-only captures
+	auto state = std::make_unique<int>(42);
+	fuse(counted_kernel{} | [state = std::move(state)](handler) { assert(*state == 42); }) | submit_to(q);
+
+	q.wait();
+
+	cout << "action copies: " << counted_kernel::copies << endl;
+	return counted_kernel::copies == 0;
+}
+
 void sequence_examples()
 {
 	// example 1: generic action sequence
@@ -186,6 +240,109 @@ void sequence_examples()
 	auto add_one = actions::transform(distr<class add_one>(q), begin(b), end(b), begin(b_out), [](float x) { return x + 1.0f; });
 
 	zero | fuse(step | step | step) | step | add_one | submit_to(q);
+
+	// multi-dimensional algorithms
+
+	buffer<float, 2> m{ { 3, 3 } };
+	buffer<float, 2> m_out{ { 3, 3 } };
+
+	algorithm::generate(distr<class diagonal>(q), begin(m), end(m), [](cl::sycl::item<2> item) { return item[0] == item[1] ? 1.f : 0.f; });
+	algorithm::transform(distr<class scale>(q), begin(m), end(m), begin(m_out), [](float x) { return 2 * x; });
+
+	auto trace = algorithm::reduce(master(q), begin(m_out), end(m_out), 0.f, [](float acc, float x) { return acc + x; });
+	cout << "trace: " << trace.get() << endl;
+
+	// chunk access
+
+	buffer<float, 1> chunk_sums{ { 3 } };
+
+	algorithm::for_each(distr<class local_sort>(q), begin(b), end(b), [](algorithm::chunk<float, 1> chnk) { std::sort(chnk.begin(), chnk.end()); }, cl::sycl::range<1>{ 2 });
+	algorithm::transform(distr<class blocked_sum>(q), begin(b), end(b), begin(chunk_sums),
+		[](algorithm::chunk<float, 1> chnk)
+		{
+			return std::accumulate(chnk.begin(), chnk.end(), 0.f);
+		}, cl::sycl::range<1>{ 2 });
+
+	// buffer windows
+
+	algorithm::fill(distr<class fill_window>(q), begin(b) + 1, end(b) - 1, 1.f);
+	algorithm::transform(distr<class shift_window>(q), begin(b) + 1, begin(b) + 3, begin(c) + 2, [](float x) { return x + 1; });
+
+	// structure of arrays: position, velocity, mass; kernels access only the selected fields
+
+	algorithm::soa_buffer<float, float, float> particles{ { 4 } };
+
+	algorithm::fill(distr<class init_mass>(q), algorithm::field<2>(begin(particles)), algorithm::field<2>(end(particles)), 1.f);
+	algorithm::for_each(distr<class drift>(q), algorithm::select<0, 1>(begin(particles)), algorithm::select<0, 1>(end(particles)), [](float& x, float& v) { v += 1; x += v; });
+
+	buffer<float, 1> momentum{ { 4 } };
+	algorithm::transform(distr<class momentum>(q), begin(momentum), end(momentum), [](float v, float m) { return v * m; },
+		algorithm::field<1>(begin(particles)), algorithm::field<2>(begin(particles)));
+
+	// half precision storage, decoded when read and encoded when written by kernels
+
+	buffer<algorithm::float16, 1> compressed{ { 4 } };
+
+	algorithm::transform(distr<class compress>(q), begin(compressed), end(compressed), [](float x) { return x; }, begin(momentum));
+	algorithm::transform(distr<class decompress>(q), begin(momentum), end(momentum), [](float x) { return 2 * x; }, begin(compressed));
+
+	// work distribution, only honoured by the multi-rank mock (MOCK_CELERITY_MPI)
+
+	algorithm::fill(distr<class weighted_fill>(q, std::make_shared<algorithm::weighted_split>(std::vector<double>{ 3, 1 })), begin(c), end(c), 1.f);
+
+	const auto balanced = std::make_shared<algorithm::throughput_split>();
+	for (auto i = 0; i < 2; ++i)
+	{
+		algorithm::transform(distr<class balanced_scale>(q, balanced), begin(c), end(c), begin(c), [](float x) { return 2 * x; });
+	}
+
+	algorithm::transform(distr<class blocked_scale>(q, std::make_shared<algorithm::block_split>()), begin(m), end(m), begin(m_out), [](float x) { return 2 * x; });
+
+	// distributed sort
+
+	algorithm::sort(distr<class sort_b>(q), begin(b), end(b), std::greater<float>{}, cl::sycl::range<1>{ 2 });
+	algorithm::sort_by_key(distr<class sort_c_by_b>(q), begin(b), end(b), begin(c));
+
+	// histogram
+
+	buffer<int, 1> b_bins{ { 4 } };
+	algorithm::histogram(distr<class bin_b>(q), begin(b), end(b), begin(b_bins), end(b_bins), [](float x) { return static_cast<int>(x); });
+
+	// linear algebra
+
+	auto dot = algorithm::inner_product(distr<class dot_b_c>(q), begin(b), end(b), begin(c), 0.f);
+	cout << "dot: " << dot.get() << endl;
+
+	auto [sum_b, max_b, positive_b] = algorithm::reduce_many(distr<class stats_b>(q), begin(b), end(b),
+		algorithm::reduction(0.f, std::plus<float>{}),
+		algorithm::reduction(std::numeric_limits<float>::lowest(), [](float x, float y) { return std::max(x, y); }),
+		algorithm::reduction(0, std::plus<int>{}, [](float x) { return x > 0 ? 1 : 0; })).get();
+	cout << "sum: " << sum_b << ", max: " << max_b << ", positive: " << positive_b << endl;
+
+	buffer<float, 2> m_product{ { 3, 3 } };
+	algorithm::gemm(distr<class square>(q), begin(m), end(m), begin(m_out), end(m_out), begin(m_product), 2);
+
+	// 1D laplacian, every chunk of rows fetches only the neighbouring entries of x
+	algorithm::csr_matrix<float> laplacian{ 4, 4, { 0, 2, 5, 8, 10 }, { 0, 1, 0, 1, 2, 1, 2, 3, 2, 3 }, { 2, -1, -1, 2, -1, -1, 2, -1, -1, 2 } };
+	buffer<float, 1> b_laplacian{ { 4 } };
+	algorithm::spmv(distr<class laplace_b>(q), laplacian, begin(b), begin(b) + 4, begin(b_laplacian));
+
+	// profiling
+
+	profiler::instance().enable();
+
+	algorithm::gemm(distr<class square_again>(q), begin(m_product), end(m_product), begin(m_out), end(m_out), begin(m), 2);
+	algorithm::inner_product(master_blocking(q), begin(m), end(m), begin(m_out), 0.f);
+	q.wait();
+
+	// written to SEQUENCES_TRACE, or to the temporary directory if it is not set
+	const auto* const trace_path = std::getenv("SEQUENCES_TRACE");
+	const auto trace_file_path = trace_path ? std::filesystem::path{ trace_path } : std::filesystem::temp_directory_path() / "sequences_trace.json";
+
+	std::ofstream trace_file{ trace_file_path };
+	profiler::instance().write_chrome_trace(trace_file);
+	cout << "trace written to " << trace_file_path.string() << endl;
+	profiler::instance().disable();
 }
 
 void iterator_static_assertions()
@@ -240,15 +397,1190 @@ void iterator_static_assertions()
 	static_assert(is_invocable_v<decltype(task(kernel)), distr_queue&>, "task(kernel) invocable with queue");
 }
 
-int main(int, char*[]) {
+bool report(const char* name, bool ok)
+{
+	cout << name << ": " << (ok ? "ok" : "FAILED") << endl;
+	return ok;
+}
+
+// contents of a buffer, read by a master task so that every rank sees the current values
+template<typename T, size_t Rank>
+std::vector<T> host_copy(celerity::distr_queue q, const celerity::buffer<T, Rank>& b)
+{
+	using namespace celerity;
+
+	return algorithm::task<algorithm::blocking_master_execution_policy>([&](handler cgh)
+		{
+			auto acc = b.template get_access<access_mode::read>(cgh, b.get_range());
+
+			std::vector<T> values;
+			cgh.run([&]() { values.assign(acc.get_pointer(), acc.get_pointer() + b.size()); });
+
+			return values;
+		}) | algorithm::submit_to(q);
+}
+
+// N-D algorithms against row-major host results, on a non-square matrix and a 3-D buffer
+bool nd_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	buffer<float, 2> m{ { 3, 4 } };
+	buffer<float, 2> m_out{ { 3, 4 } };
+
+	algorithm::generate(distr<class check_diagonal>(q), begin(m), end(m), [](cl::sycl::item<2> item) { return item[0] == item[1] ? 1.f : 0.f; });
+	algorithm::transform(distr<class check_scale>(q), begin(m), end(m), begin(m_out), [](float x) { return 2 * x; });
+	const auto trace = algorithm::reduce(master_blocking(q), begin(m_out), end(m_out), 0.f, [](float acc, float x) { return acc + x; });
+
+	std::vector<float> expected(12, 0.f);
+	for (auto i = 0; i < 3; ++i) expected[i * 4 + i] = 2.f;
+
+	auto ok = host_copy(q, m_out) == expected && trace == 6.f;
+
+	// every element holds its row-major linear index
+	buffer<int, 3> cube{ { 2, 3, 4 } };
+	algorithm::generate(distr<class check_linear_index>(q), begin(cube), end(cube), [](cl::sycl::item<3> item) { return (item[0] * 3 + item[1]) * 4 + item[2]; });
+
+	std::vector<int> linear(24);
+	std::iota(linear.begin(), linear.end(), 0);
+
+	ok = ok && host_copy(q, cube) == linear;
+
+	// iterators move along the last dimension first and span whole rows
+	auto it = begin(cube);
+	for (auto i = 0; i < 4; ++i) ++it;
+	ok = ok && *it == cl::sycl::id<3>{ 0, 1, 0 };
+
+	for (auto i = 0; i < 8; ++i) ++it;
+	ok = ok && *it == cl::sycl::id<3>{ 1, 0, 0 } && algorithm::detail::distance(it, end(cube)) == cl::sycl::range<3>{ 1, 3, 4 };
+
+	for (auto i = 0; i < 12; ++i) ++it;
+	ok = ok && it == end(cube) && algorithm::detail::distance(begin(cube), end(cube)) == cl::sycl::range<3>{ 2, 3, 4 };
+
+	auto row = begin(m);
+	for (auto i = 0; i < 4; ++i) ++row;
+	ok = ok && algorithm::detail::distance(row, end(m)) == cl::sycl::range<2>{ 2, 4 };
+
+	return report("n-d algorithms", ok);
+}
+
+// slices along either dimension of a 3x4 matrix holding its row-major linear index
+bool slice_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	buffer<float, 2> m{ { 3, 4 } };
+	buffer<float, 2> rows{ { 3, 4 } };
+	buffer<float, 2> columns{ { 3, 4 } };
+
+	algorithm::generate(distr<class slice_input>(q), begin(m), end(m), [](cl::sycl::item<2> item) { return item[0] * 4.f + item[1]; });
+
+	// weighting by position tells apart slices that walk the wrong dimension
+	const auto weighted_sum = [](slice<float, 2> x)
+	{
+		auto sum = 0.f;
+
+		for (int i = 0; i < x.size(); ++i)
+			sum += (i + 1) * x[i];
+
+		return 100 * *x + sum;
+	};
+
+	algorithm::transform(distr<class row_slice>(q), begin(m), end(m), begin(rows), weighted_sum, 1);
+	algorithm::transform(distr<class column_slice>(q), begin(m), end(m), begin(columns), weighted_sum, 0);
+
+	std::vector<float> expected_rows(12);
+	std::vector<float> expected_columns(12);
+
+	for (auto i = 0; i < 3; ++i)
+	{
+		for (auto j = 0; j < 4; ++j)
+		{
+			auto row = 0.f;
+			for (auto k = 0; k < 4; ++k) row += (k + 1) * (i * 4.f + k);
+
+			auto column = 0.f;
+			for (auto k = 0; k < 3; ++k) column += (k + 1) * (k * 4.f + j);
+
+			expected_rows[i * 4 + j] = 100 * (i * 4.f + j) + row;
+			expected_columns[i * 4 + j] = 100 * (i * 4.f + j) + column;
+		}
+	}
+
+	auto ok = host_copy(q, rows) == expected_rows && host_copy(q, columns) == expected_columns;
+
+	// a chunk requests the whole extent of the slice dimension and only its own range of the others
+	const celerity::chunk<2> chnk{ { 1, 2 }, { 1, 2 }, { 3, 4 } };
+	const auto along_rows = access::slice<2>(1)(chnk);
+	const auto along_columns = access::slice<2>(0)(chnk);
+
+	ok = ok && along_rows.offset == cl::sycl::id<2>{ 1, 0 } && along_rows.range == cl::sycl::range<2>{ 1, 4 };
+	ok = ok && along_columns.offset == cl::sycl::id<2>{ 0, 2 } && along_columns.range == cl::sycl::range<2>{ 3, 2 };
+
+	return report("slices", ok);
+}
+
+// chunks narrower than a row of a 4x6 matrix, filled with descending values
+bool chunk_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	buffer<int, 2> m{ { 4, 6 } };
+	buffer<int, 2> sums{ { 2, 2 } };
+	buffer<int, 2> offsets{ { 2, 2 } };
+
+	const cl::sycl::range<2> chunk_size{ 2, 3 };
+
+	algorithm::generate(distr<class chunk_input>(q), begin(m), end(m), [](cl::sycl::item<2> item) { return 23 - (item[0] * 6 + item[1]); });
+
+	algorithm::transform(distr<class chunk_offsets>(q), begin(m), end(m), begin(offsets),
+		[](algorithm::chunk<int, 2> chnk) { return chnk.contiguous() ? -1 : chnk.offset()[0] * 10 + chnk.offset()[1]; }, chunk_size);
+	algorithm::for_each(distr<class chunk_sort>(q), begin(m), end(m), [](algorithm::chunk<int, 2> chnk) { std::sort(chnk.begin(), chnk.end()); }, chunk_size);
+	algorithm::transform(distr<class chunk_sums>(q), begin(m), end(m), begin(sums),
+		[](algorithm::chunk<int, 2> chnk) { return std::accumulate(chnk.begin(), chnk.end(), 0) + chnk[{ 1, 2 }]; }, chunk_size);
+
+	std::vector<int> expected(24);
+	std::vector<int> expected_sums(4);
+
+	for (auto ci = 0; ci < 2; ++ci)
+	{
+		for (auto cj = 0; cj < 2; ++cj)
+		{
+			std::vector<int> block;
+			for (auto i = 0; i < 2; ++i)
+				for (auto j = 0; j < 3; ++j)
+					block.push_back(23 - ((ci * 2 + i) * 6 + cj * 3 + j));
+
+			std::sort(block.begin(), block.end());
+
+			for (auto i = 0; i < 2; ++i)
+				for (auto j = 0; j < 3; ++j)
+					expected[(ci * 2 + i) * 6 + cj * 3 + j] = block[i * 3 + j];
+
+			expected_sums[ci * 2 + cj] = std::accumulate(block.begin(), block.end(), 0) + block.back();
+		}
+	}
+
+	const auto ok = host_copy(q, m) == expected && host_copy(q, sums) == expected_sums &&
+		host_copy(q, offsets) == std::vector<int>{ 0, 3, 20, 23 };
+
+	return report("chunks", ok);
+}
+
+// the same pseudo-random values on every rank
+std::vector<int> host_values(int n, int modulus)
+{
+	std::vector<int> values(n);
+
+	unsigned state = 12345;
+	for (auto& x : values)
+	{
+		state = state * 1103515245u + 12345u;
+		x = static_cast<int>((state >> 16) % modulus);
+	}
+
+	return values;
+}
+
+bool sort_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	const auto keys = host_values(200, 50);
+	std::vector<int> ids(keys.size());
+	std::iota(ids.begin(), ids.end(), 0);
+
+	// several chunks, so that every step of the sample sort runs
+	buffer<int, 1> sorted{ keys.data(), { 200 } };
+	algorithm::sort(distr<class check_sort>(q), begin(sorted), end(sorted), std::less<int>{}, cl::sycl::range<1>{ 32 });
+
+	// a distributed task right after the sort reads the merged output
+	buffer<int, 1> doubled{ { 200 } };
+	algorithm::transform(distr<class check_after_sort>(q), begin(sorted), end(sorted), begin(doubled), [](int x) { return 2 * x; });
+
+	buffer<int, 1> descending{ keys.data(), { 200 } };
+	algorithm::sort(distr<class check_sort_descending>(q), begin(descending), end(descending), std::greater<int>{}, cl::sycl::range<1>{ 48 });
+
+	buffer<int, 1> by_key{ keys.data(), { 200 } };
+	buffer<int, 1> values{ ids.data(), { 200 } };
+	algorithm::sort_by_key(distr<class check_sort_by_key>(q), begin(by_key), end(by_key), begin(values), std::less<int>{}, cl::sycl::range<1>{ 32 });
+
+	auto expected = keys;
+	std::sort(expected.begin(), expected.end());
+
+	auto expected_doubled = expected;
+	for (auto& x : expected_doubled) x *= 2;
+
+	auto expected_descending = keys;
+	std::sort(expected_descending.begin(), expected_descending.end(), std::greater<int>{});
+
+	// stable: ids of equal keys stay in ascending order
+	auto expected_ids = ids;
+	std::stable_sort(expected_ids.begin(), expected_ids.end(), [&](int lhs, int rhs) { return keys[lhs] < keys[rhs]; });
+
+	return report("sort", host_copy(q, sorted) == expected && host_copy(q, doubled) == expected_doubled
+		&& host_copy(q, descending) == expected_descending && host_copy(q, by_key) == expected && host_copy(q, values) == expected_ids);
+}
+
+// small integers, so that every sum below is exact in float
+bool linear_algebra_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	std::vector<float> a(5 * 4), b(4 * 3);
+	for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<float>(i % 7) - 3;
+	for (size_t i = 0; i < b.size(); ++i) b[i] = static_cast<float>(i % 5) - 2;
+
+	buffer<float, 2> a_buf{ a.data(), { 5, 4 } };
+	buffer<float, 2> b_buf{ b.data(), { 4, 3 } };
+	buffer<float, 2> c_buf{ { 5, 3 } };
+
+	// tiles do not divide the result
+	algorithm::gemm(distr<class check_gemm>(q), begin(a_buf), end(a_buf), begin(b_buf), end(b_buf), begin(c_buf), 2);
+
+	std::vector<float> c(5 * 3, 0.f);
+	for (auto i = 0; i < 5; ++i)
+		for (auto j = 0; j < 3; ++j)
+			for (auto k = 0; k < 4; ++k)
+				c[i * 3 + j] += a[i * 4 + k] * b[k * 3 + j];
+
+	std::vector<float> x(20), y(20);
+	for (auto i = 0; i < 20; ++i) { x[i] = static_cast<float>(i % 4); y[i] = static_cast<float>(3 - i % 5); }
+
+	buffer<float, 1> x_buf{ x.data(), { 20 } };
+	buffer<float, 1> y_buf{ y.data(), { 20 } };
+
+	const auto dot = std::inner_product(x.begin(), x.end(), y.begin(), 1.f);
+
+	auto distributed = algorithm::inner_product(distr<class check_dot>(q), begin(x_buf), end(x_buf), begin(y_buf), 1.f);
+	auto chunked = algorithm::actions::inner_product(distr<class check_dot_chunks>(q), begin(x_buf), end(x_buf), begin(y_buf), 1.f,
+		std::plus<float>{}, std::multiplies<float>{}, cl::sycl::range<1>{ 3 }) | submit_to(q);
+	const auto on_master = algorithm::inner_product(master_blocking(q), begin(x_buf), end(x_buf), begin(y_buf), 1.f);
+
+	return report("linear algebra", host_copy(q, c_buf) == c && distributed.get() == dot && chunked.get() == dot && on_master == dot);
+}
+
+// windows of a buffer, iterator arithmetic and the range mapper behind window accesses
+bool window_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	std::vector<float> zeros(8, 0.f);
+
+	buffer<float, 1> x{ { 8 } };
+	buffer<float, 1> filled{ zeros.data(), { 8 } };
+	buffer<float, 1> shifted{ zeros.data(), { 8 } };
+
+	algorithm::generate(distr<class window_input>(q), begin(x), end(x), [](cl::sycl::item<1> item) { return static_cast<float>(item[0]); });
+	algorithm::fill(distr<class check_fill_window>(q), begin(filled) + 1, end(filled) - 1, 1.f);
+	algorithm::transform(distr<class check_shift_window>(q), begin(x) + 1, begin(x) + 3, begin(shifted) + 2, [](float v) { return v + 1; });
+	algorithm::transform(master(q), begin(x) + 5, end(x), begin(shifted) + 5, [](float v) { return -v; });
+
+	auto ok = host_copy(q, filled) == std::vector<float>{ 0, 1, 1, 1, 1, 1, 1, 0 } &&
+		host_copy(q, shifted) == std::vector<float>{ 0, 0, 2, 3, 0, -5, -6, -7 };
+
+	// rows 1 and 2 of a 4x3 matrix, written one row further down
+	buffer<int, 2> m{ { 4, 3 } };
+	buffer<int, 2> rows{ { 4, 3 } };
+
+	algorithm::generate(distr<class window_matrix>(q), begin(m), end(m), [](cl::sycl::item<2> item) { return item[0] * 3 + item[1]; });
+	algorithm::fill(distr<class window_rows_clear>(q), begin(rows), end(rows), -1);
+	algorithm::transform(distr<class window_rows>(q), begin(m) + 3, begin(m) + 9, begin(rows) + 6, [](int v) { return v * 10; });
+
+	ok = ok && host_copy(q, rows) == std::vector<int>{ -1, -1, -1, -1, -1, -1, 30, 40, 50, 60, 70, 80 };
+
+	// random-access iterator arithmetic in row-major order
+	auto it = begin(m) + 5;
+
+	ok = ok && *it == cl::sycl::id<2>{ 1, 2 } && *(it + 4) == cl::sycl::id<2>{ 3, 0 } && *(2 + it) == cl::sycl::id<2>{ 2, 1 };
+	ok = ok && it[1] == cl::sycl::id<2>{ 2, 0 } && it - 5 == begin(m) && end(m) - it == 7 && begin(m) - it == -5;
+	ok = ok && begin(m) < it && it <= it && end(m) > it && it >= begin(m) && !(it < it) && !(end(m) <= it);
+
+	--it;
+	ok = ok && *it == cl::sycl::id<2>{ 1, 1 } && *(it += 3) == cl::sycl::id<2>{ 2, 1 } && *(it -= 7) == cl::sycl::id<2>{ 0, 0 };
+
+	// shifted chunks are clipped at both edges of the buffer
+	const auto before = algorithm::detail::offset_range_mapper<1>{ { -2 }, { 8 } }(celerity::chunk<1>{ { 0 }, { 4 }, { 8 } });
+	const auto after = algorithm::detail::offset_range_mapper<1>{ { 6 }, { 8 } }(celerity::chunk<1>{ { 0 }, { 4 }, { 8 } });
+	const auto corner = algorithm::detail::offset_range_mapper<2>{ { -1, 1 }, { 4, 3 } }(celerity::chunk<2>{ { 0, 0 }, { 2, 3 }, { 4, 3 } });
+
+	ok = ok && before.offset == cl::sycl::id<1>{ 0 } && before.range == cl::sycl::range<1>{ 2 };
+	ok = ok && after.offset == cl::sycl::id<1>{ 6 } && after.range == cl::sycl::range<1>{ 2 };
+	ok = ok && corner.offset == cl::sycl::id<2>{ 0, 1 } && corner.range == cl::sycl::range<2>{ 1, 2 };
+
+	return report("windows", ok);
+}
+
+// access modes and sizes recorded for the tasks submitted by f
+template<typename F>
+std::vector<std::string> recorded_accesses(celerity::distr_queue q, F f)
+{
+	using celerity::algorithm::profiler;
+
+	q.wait();
+	profiler::instance().clear();
+	profiler::instance().enable();
+	f();
+	profiler::instance().disable();
+
+	// profiles are committed once their tasks are done
+	q.wait();
+
+	std::vector<std::string> accesses;
+	for (const auto& record : profiler::instance().records())
+	{
+		for (const auto& access : record.accesses)
+		{
+			accesses.push_back(std::string{ access.mode } + ":" + std::to_string(access.bytes));
+		}
+	}
+
+	profiler::instance().clear();
+	return accesses;
+}
+
+// outputs that are fully overwritten discard their old contents, read-modify-write keeps them
+bool access_mode_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	buffer<int, 1> x{ { 8 } };
+	buffer<int, 1> out{ { 8 } };
+
+	algorithm::generate(distr<class access_input>(q), begin(x), end(x), [](cl::sycl::item<1> item) { return item[0]; });
+	algorithm::fill(distr<class access_old>(q), begin(out), end(out), 7);
+
+	const auto overwrite = recorded_accesses(q, [&]()
+		{
+			algorithm::fill(distr<class access_fill>(q), begin(out), end(out), 1);
+			algorithm::transform(distr<class access_transform>(q), begin(x), end(x), begin(out), [](int v) { return 10 * v; });
+		});
+
+	auto ok = host_copy(q, out) == std::vector<int>{ 0, 10, 20, 30, 40, 50, 60, 70 };
+	ok = ok && overwrite == std::vector<std::string>{ "discard_write:32", "read:32", "discard_write:32" };
+
+	// a window only discards the elements it writes, the rest of the buffer keeps its values
+	const auto window = recorded_accesses(q, [&]() { algorithm::fill(distr<class access_window>(q), begin(out) + 2, begin(out) + 5, -1); });
+
+	ok = ok && host_copy(q, out) == std::vector<int>{ 0, 10, -1, -1, -1, 50, 60, 70 };
+	ok = ok && window == std::vector<std::string>{ "discard_write:12" };
+
+	const auto update = recorded_accesses(q, [&]() { algorithm::for_each(distr<class access_update>(q), begin(out), end(out), [](int& v) { v += 1; }); });
+
+	ok = ok && host_copy(q, out) == std::vector<int>{ 1, 11, 0, 0, 0, 51, 61, 71 };
+	ok = ok && update == std::vector<std::string>{ "read_write:32" };
+
+	return report("access modes", ok);
+}
+
+// dependencies, concurrency and errors of the mock runtime
+bool runtime_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	// a read-after-write chain across buffers, followed by a write to a buffer the chain read
+	buffer<int, 1> a{ { 64 } };
+	buffer<int, 1> b{ { 64 } };
+	buffer<int, 1> c{ { 64 } };
+
+	algorithm::generate(distr<class chain_a>(q), begin(a), end(a), [](cl::sycl::item<1> item) { return item[0]; });
+	algorithm::transform(distr<class chain_b>(q), begin(a), end(a), begin(b), [](int x) { return x + 1; });
+	algorithm::transform(distr<class chain_c>(q), begin(b), end(b), begin(c), [](int x) { return 3 * x; });
+	algorithm::fill(distr<class chain_overwrite>(q), begin(a), end(a), -1);
+	algorithm::transform(distr<class chain_sum>(q), begin(a), end(a), begin(c), begin(c), [](int x, int y) { return x + y; });
+
+	std::vector<int> expected(64);
+	for (auto i = 0; i < 64; ++i) expected[i] = 3 * (i + 1) - 1;
+
+	auto ok = host_copy(q, c) == expected;
+
+	// a parallel_for is split across the workers, every item still runs exactly once
+	buffer<int, 2> visits{ { 37, 5 } };
+
+	q.submit([=](handler cgh)
+		{
+			auto acc = visits.get_access<access_mode::read_write>(cgh, celerity::access::one_to_one<2>{});
+			cgh.parallel_for<class split_dispatch>(visits.get_range(), [&](cl::sycl::item<2> item) { ++acc[item]; });
+		});
+
+	ok = ok && host_copy(q, visits) == std::vector<int>(37 * 5, 1);
+
+	// command groups on disjoint buffers run at the same time if there are workers to run them
+	if (celerity::detail::runtime::instance().workers() > 1)
+	{
+		std::atomic<int> arrived{ 0 };
+		std::atomic<int> overlapped{ 0 };
+
+		buffer<int, 1> first{ { 1 } };
+		buffer<int, 1> second{ { 1 } };
+
+		for (auto buf : { first, second })
+		{
+			q.submit([=, &arrived, &overlapped](handler cgh)
+				{
+					auto acc = buf.get_access<access_mode::discard_write>(cgh, buf.get_range());
+
+					cgh.run([&]()
+						{
+							++arrived;
+
+							const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 5 };
+							while (arrived < 2 && std::chrono::steady_clock::now() < deadline)
+							{
+								std::this_thread::yield();
+							}
+
+							if (arrived == 2) ++overlapped;
+						});
+				});
+		}
+
+		q.wait();
+		ok = ok && overlapped == 2;
+	}
+
+	// an exception thrown by a kernel is rethrown by wait
+	q.submit([=](handler cgh)
+		{
+			auto acc = a.get_access<access_mode::read>(cgh, a.get_range());
+			cgh.parallel_for<class throwing_kernel>(a.get_range(), [=](cl::sycl::item<1>) { throw std::runtime_error{ "kernel failed" }; });
+		});
+
+	auto rethrown = false;
+
+	try
+	{
+		q.wait();
+	}
+	catch (const std::runtime_error& e)
+	{
+		rethrown = std::string{ e.what() } == "kernel failed";
+	}
+
+	return report("runtime", ok && rethrown);
+}
+
+#ifdef MOCK_CELERITY_MPI
+// every rank runs its block of rows of a kernel and reads the values other ranks wrote
+bool mpi_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	const auto& world = celerity::detail::mpi_world::instance();
+
+	buffer<int, 2> owner{ { 7, 3 } };
+	buffer<int, 2> next{ { 7, 3 } };
+
+	algorithm::generate(distr<class mpi_owner>(q), begin(owner), end(owner), [rank = world.rank()](cl::sycl::item<2>) { return rank; });
+
+	// reads the first row of the block of the next rank
+	algorithm::transform(distr<class mpi_next_row>(q), begin(owner) + 3, end(owner), begin(next), [](int r) { return r; });
+
+	std::vector<int> expected(21);
+	for (auto r = 0; r < world.size(); ++r)
+	{
+		for (auto row = 7 * r / world.size(); row < 7 * (r + 1) / world.size(); ++row)
+		{
+			std::fill_n(expected.begin() + row * 3, 3, r);
+		}
+	}
+
+	auto expected_next = std::vector<int>(expected.begin() + 3, expected.end());
+	expected_next.resize(21, 0);
+
+	// a master access gathers the rows of all other ranks
+	const auto received = celerity::detail::communication().bytes_received;
+	const auto owners = host_copy(q, owner);
+	const auto gathered = celerity::detail::communication().bytes_received > received;
+
+	const auto ok = owners == expected && host_copy(q, next) == expected_next;
+
+	return report("mpi ranks", ok && (world.size() == 1 || gathered));
+}
+#endif
+
+// split strategies, and on several ranks the rows each rank executes
+bool split_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	const auto kernel = kernel_id_of<class split_feedback>();
+	const auto weighted = std::make_shared<weighted_split>(std::vector<double>{ 1, 3 });
+	const auto balanced = std::make_shared<throughput_split>(0.5);
+
+	auto ok = even_split{}.weights(kernel, 2).empty() && weighted->weights(kernel, 3) == std::vector<double>{ 1, 3, 1 };
+
+	// even until every node has been measured, then proportional to the smoothed items per second
+	ok = ok && balanced->weights(kernel, 2).empty();
+	balanced->observe(kernel, { 50, 50 }, { 1.0, 0.25 });
+	ok = ok && balanced->weights(kernel, 2) == std::vector<double>{ 50, 200 };
+	balanced->observe(kernel, { 20, 80 }, { 1.0, 1.0 });
+	ok = ok && balanced->weights(kernel, 2) == std::vector<double>{ 35, 140 };
+
+	// the feedback belongs to the kernel name: a new strategy object continues where the last left
+	// off, while another kernel starts with an even split
+	ok = ok && throughput_split{}.weights(kernel, 2) == std::vector<double>{ 35, 140 };
+	ok = ok && throughput_split{}.weights(kernel_id_of<class split_feedback_other>(), 2).empty();
+
+#ifdef MOCK_CELERITY_MPI
+	const auto& world = celerity::detail::mpi_world::instance();
+
+	// rank ranges follow the weights and shift once unequal times have been observed
+	const auto first = celerity::detail::rank_chunk(cl::sycl::range<1>{ 100 }, 0, { weighted->weights(kernel, 2), { 2, 1, 1 } });
+	const auto second = celerity::detail::rank_chunk(cl::sycl::range<1>{ 100 }, 1, { weighted->weights(kernel, 2), { 2, 1, 1 } });
+	const auto rebalanced = celerity::detail::rank_chunk(cl::sycl::range<1>{ 100 }, 1, { balanced->weights(kernel, 2), { 2, 1, 1 } });
+
+	ok = ok && first.offset[0] == 0 && first.range[0] == 25 && second.offset[0] == 25 && second.range[0] == 75;
+	ok = ok && rebalanced.offset[0] == 20 && rebalanced.range[0] == 80;
+
+	// every rank writes its id into the rows it executes
+	distr_queue q;
+	buffer<int, 2> owner{ { 8, 2 } };
+
+	algorithm::generate(distr<class split_owner>(q, weighted), begin(owner), end(owner), [rank = world.rank()](cl::sycl::item<2>) { return rank; });
+
+	const auto weights = weighted->weights(kernel_id_of<class split_owner>(), world.size());
+	const auto total = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+	std::vector<int> expected(16);
+	auto before = 0.0;
+	for (auto r = 0; r < world.size(); ++r)
+	{
+		const auto begin_row = static_cast<int>(8 * (before / total));
+		before += weights[r];
+		const auto end_row = r + 1 == world.size() ? 8 : static_cast<int>(8 * (before / total));
+
+		std::fill(expected.begin() + 2 * begin_row, expected.begin() + 2 * end_row, r);
+	}
+
+	ok = ok && host_copy(q, owner) == expected;
+#endif
+
+	return report("split strategies", ok);
+}
+
+// elements outside of its block that each block of a 2-D grid reads with a 3x3 stencil, summed over all blocks
+int halo_elements(const std::array<int, 3>& grid, cl::sycl::range<2> size)
+{
+	const celerity::access::neighborhood<2> stencil{ 1, 1 };
+
+	auto halo = 0;
+	for (auto i = 0; i < grid[0]; ++i)
+	{
+		for (auto j = 0; j < grid[1]; ++j)
+		{
+			celerity::chunk<2> block{ { size[0] * i / grid[0], size[1] * j / grid[1] }, {}, size };
+			block.range = { size[0] * (i + 1) / grid[0] - block.offset[0], size[1] * (j + 1) / grid[1] - block.offset[1] };
+
+			halo += celerity::count(stencil(block).range) - celerity::count(block.range);
+		}
+	}
+
+	return halo;
+}
+
+// grids chosen by block_split and the halo they save over row slabs
+bool block_split_checks()
+{
+	using celerity::algorithm::detail::surface_minimising_grid;
+
+	using grid = std::array<int, 3>;
+
+	auto ok = surface_minimising_grid(4, { 64, 64, 1 }) == grid{ 2, 2, 1 };
+	ok = ok && surface_minimising_grid(16, { 64, 64, 1 }) == grid{ 4, 4, 1 };
+	ok = ok && surface_minimising_grid(8, { 32, 32, 32 }) == grid{ 2, 2, 2 };
+
+	// prime node counts, dimensions too small to be split and ties all end up in slabs of the outer dimension
+	ok = ok && surface_minimising_grid(7, { 64, 64, 1 }) == grid{ 7, 1, 1 };
+	ok = ok && surface_minimising_grid(4, { 64, 1, 1 }) == grid{ 4, 1, 1 };
+	ok = ok && surface_minimising_grid(2, { 64, 64, 1 }) == grid{ 2, 1, 1 };
+
+	// blocks of 32x32 and 16x16 instead of slabs of 16 and 4 rows
+	ok = ok && halo_elements({ 2, 2, 1 }, { 64, 64 }) == 260 && halo_elements({ 4, 1, 1 }, { 64, 64 }) == 384;
+	ok = ok && halo_elements({ 4, 4, 1 }, { 64, 64 }) == 804 && halo_elements({ 16, 1, 1 }, { 64, 64 }) == 1920;
+
+#ifdef MOCK_CELERITY_MPI
+	// ranks are laid out row-major over the grid
+	const auto block = celerity::detail::rank_chunk(cl::sycl::range<2>{ 64, 64 }, 1, { {}, { 2, 2, 1 } });
+	ok = ok && block.offset == cl::sycl::id<2>{ 0, 32 } && block.range == cl::sycl::range<2>{ 32, 32 };
+#endif
+
+	return report("block split", ok);
+}
+
+bool scratch_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+	auto& pool = scratch_pool::instance();
+
+	// a released buffer is handed out again, a leased one is not
+	const buffer<int, 1>* released;
+	{
+		const auto lease = pool.acquire<int>(cl::sycl::range<1>{ 13 });
+		released = lease.get();
+	}
+
+	const auto reused = pool.acquire<int>(cl::sycl::range<1>{ 13 });
+	const auto fresh = pool.acquire<int>(cl::sycl::range<1>{ 13 });
+
+	auto ok = reused.get() == released && fresh.get() != released;
+
+	// the temporaries of a repeated sort come from the pool, and its results are unaffected by reuse
+	const auto keys = host_values(100, 20);
+	auto expected = keys;
+	std::sort(expected.begin(), expected.end());
+
+	buffer<int, 1> first{ keys.data(), { 100 } };
+	algorithm::sort(distr<class check_scratch_first>(q), begin(first), end(first), std::less<int>{}, cl::sycl::range<1>{ 25 });
+	q.wait();
+
+	const auto before = pool.stats();
+
+	buffer<int, 1> second{ keys.data(), { 100 } };
+	algorithm::sort(distr<class check_scratch_second>(q), begin(second), end(second), std::less<int>{}, cl::sycl::range<1>{ 25 });
+	q.wait();
+
+	const auto after = pool.stats();
+
+	ok = ok && after.allocations == before.allocations && after.reuses > before.reuses;
+	ok = ok && host_copy(q, first) == expected && host_copy(q, second) == expected;
+
+	// idle buffers over the limit are freed, the least recently released first
+	q.wait();
+	pool.clear();
+
+	auto small = pool.acquire<int>(cl::sycl::range<1>{ 8 });
+	auto large = pool.acquire<int>(cl::sycl::range<1>{ 16 });
+
+	const auto kept = pool.stats();
+
+	pool.set_idle_limit(100);
+	small.reset();
+	large.reset();
+
+	ok = ok && pool.idle_bytes() == 96 && pool.stats().evictions == kept.evictions;
+
+	pool.set_idle_limit(64);
+
+	ok = ok && pool.idle_bytes() == 64 && pool.stats().evictions == kept.evictions + 1;
+	ok = ok && pool.acquire<int>(cl::sycl::range<1>{ 16 }) && pool.stats().reuses == kept.reuses + 1;
+	ok = ok && pool.acquire<int>(cl::sycl::range<1>{ 8 }) && pool.stats().allocations == kept.allocations + 1;
+
+	pool.set_idle_limit(scratch_pool::default_idle_limit);
+
+	return report("scratch", ok);
+}
+
+bool task_graph_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	std::vector<float> values(8);
+	std::iota(values.begin(), values.end(), 1.f);
+
+	buffer<float, 1> in{ values.data(), { 8 } };
+	buffer<float, 1> out{ { 8 } };
+
+	const parameter<float> factor{ 1.f };
+	const parameter<float> offset{ 0.f };
+
+	const auto graph = record(q, [&](distr_queue rq)
+		{
+			algorithm::transform(distr<class check_replayed>(rq), begin(in), end(in), begin(out), [factor, offset](float x) { return factor.get() * x + offset.get(); });
+		});
+
+	const auto expected = [&](float f, float o)
+	{
+		auto v = values;
+		for (auto& x : v) x = f * x + o;
+		return v;
+	};
+
+	// recording executes the tasks with the initial values
+	auto ok = graph.size() == 1 && host_copy(q, out) == expected(1, 0);
+
+	graph.replay(q, factor.bind(3.f), offset.bind(-1.f));
+	ok = ok && host_copy(q, out) == expected(3, -1);
+
+	// parameters without a binding take their initial value
+	graph.replay(q, factor.bind(0.5f));
+	ok = ok && host_copy(q, out) == expected(0.5f, 0);
+
+	return report("task graph", ok);
+}
+
+// zip transforms over three and four inputs of different element types
+bool zip_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	std::vector<int> a(24), c(24);
+	std::vector<float> b(24);
+	std::vector<double> d(24);
+
+	for (auto i = 0; i < 24; ++i)
+	{
+		a[i] = i;
+		b[i] = 0.5f * (i % 5);
+		c[i] = 7 - i % 3;
+		d[i] = 0.25 * i;
+	}
+
+	buffer<int, 2> a_buf{ a.data(), { 4, 6 } };
+	buffer<float, 2> b_buf{ b.data(), { 4, 6 } };
+	buffer<int, 2> c_buf{ c.data(), { 4, 6 } };
+	buffer<double, 2> d_buf{ d.data(), { 4, 6 } };
+	buffer<float, 2> three{ { 4, 6 } };
+	buffer<double, 2> four{ { 4, 6 } };
+	buffer<double, 2> four_on_master{ { 4, 6 } };
+
+	algorithm::transform(distr<class zip_three>(q), begin(three), end(three), [](int x, float y, int z) { return x * y - z; }, begin(a_buf), begin(b_buf), begin(c_buf));
+
+	const auto f = [](int x, float y, int z, double w) { return (x + y) * z + w; };
+	algorithm::transform(distr<class zip_four>(q), begin(four), end(four), f, begin(a_buf), begin(b_buf), begin(c_buf), begin(d_buf));
+	algorithm::transform(master(q), begin(four_on_master), end(four_on_master), f, begin(a_buf), begin(b_buf), begin(c_buf), begin(d_buf));
+
+	std::vector<float> expected_three(24);
+	std::vector<double> expected_four(24);
+
+	for (auto i = 0; i < 24; ++i)
+	{
+		expected_three[i] = a[i] * b[i] - c[i];
+		expected_four[i] = f(a[i], b[i], c[i], d[i]);
+	}
+
+	return report("zip transform", host_copy(q, three) == expected_three && host_copy(q, four) == expected_four
+		&& host_copy(q, four_on_master) == expected_four);
+}
+
+bool soa_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	// position, velocity, mass
+	algorithm::soa_buffer<float, float, float> particles{ { 10 } };
+
+	algorithm::generate(distr<class check_soa_position>(q), algorithm::field<0>(begin(particles)), algorithm::field<0>(end(particles)), [](cl::sycl::item<1> item) { return static_cast<float>(item[0]); });
+	algorithm::generate(distr<class check_soa_velocity>(q), algorithm::field<1>(begin(particles)), algorithm::field<1>(end(particles)), [](cl::sycl::item<1> item) { return static_cast<float>(item[0] % 3); });
+	algorithm::fill(distr<class check_soa_mass>(q), algorithm::field<2>(begin(particles)), algorithm::field<2>(end(particles)), 2.f);
+
+	algorithm::for_each(distr<class check_soa_drift>(q), algorithm::select<0, 1>(begin(particles)), algorithm::select<0, 1>(end(particles)), [](float& x, float& v) { v += 1; x += v; });
+
+	// soa to soa and soa to plain buffer
+	algorithm::soa_buffer<float, float> next{ { 10 } };
+	algorithm::transform(distr<class check_soa_step>(q), algorithm::select<0, 1>(begin(particles)), algorithm::select<0, 1>(end(particles)), begin(next),
+		[](float x, float v) { return std::make_tuple(x + v, 2 * v); });
+
+	buffer<float, 1> energy{ { 10 } };
+	algorithm::transform(distr<class check_soa_energy>(q), algorithm::select<1, 2>(begin(particles)), algorithm::select<1, 2>(end(particles)), begin(energy),
+		[](float v, float m) { return m * v * v / 2; });
+
+	std::vector<float> x(10), v(10), next_x(10), next_v(10), e(10);
+	for (auto i = 0; i < 10; ++i)
+	{
+		v[i] = static_cast<float>(i % 3 + 1);
+		x[i] = static_cast<float>(i) + v[i];
+		next_x[i] = x[i] + v[i];
+		next_v[i] = 2 * v[i];
+		e[i] = 2 * v[i] * v[i] / 2;
+	}
+
+	auto ok = host_copy(q, particles.field<0>()) == x && host_copy(q, particles.field<1>()) == v && host_copy(q, particles.field<2>()) == std::vector<float>(10, 2.f);
+	ok = ok && host_copy(q, next.field<0>()) == next_x && host_copy(q, next.field<1>()) == next_v && host_copy(q, energy) == e;
+
+	// random access on the iterator itself
+	const auto it = begin(particles);
+	ok = ok && end(particles) - it == 10 && (it + 4)[2] == cl::sycl::id<1>{ 6 } && it < it + 1 && 3 + it == it + 3;
+
+	return report("soa", ok);
+}
+
+// kernels on encoded buffers against the host encoding of the same values
+bool encoded_buffer_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	std::vector<float> values(16);
+	for (auto i = 0; i < 16; ++i) values[i] = (i - 8) * 60.3f;
+
+	buffer<float, 1> in{ values.data(), { 16 } };
+	buffer<float16, 1> half{ { 16 } };
+	buffer<fixed_point<8>, 1> fixed{ { 16 } };
+	buffer<float, 1> out{ { 16 } };
+
+	algorithm::transform(distr<class check_encode_half>(q), begin(half), end(half), [](float x) { return x; }, begin(in));
+	algorithm::transform(distr<class check_encode_fixed>(q), begin(fixed), end(fixed), [](float x) { return x / 3; }, begin(half));
+	algorithm::transform(distr<class check_decode>(q), begin(out), end(out), [](float h, float f) { return h + f; }, begin(half), begin(fixed));
+
+	std::vector<float> expected_half(16), expected_fixed(16), expected_out(16);
+	for (auto i = 0; i < 16; ++i)
+	{
+		expected_half[i] = half_encoding::decode(half_encoding::encode(values[i]));
+		expected_fixed[i] = fixed_point_encoding<8>::decode(fixed_point_encoding<8>::encode(expected_half[i] / 3));
+		expected_out[i] = expected_half[i] + expected_fixed[i];
+	}
+
+	const auto decoded = [](const auto& encoded_values)
+	{
+		return std::vector<float>(encoded_values.begin(), encoded_values.end());
+	};
+
+	// the outer values saturate the 16 bit fixed point range
+	auto ok = decoded(host_copy(q, half)) == expected_half && decoded(host_copy(q, fixed)) == expected_fixed && host_copy(q, out) == expected_out;
+	ok = ok && expected_fixed.front() == fixed_point_encoding<8>::decode(std::numeric_limits<std::int16_t>::lowest());
+
+	return report("encoded buffers", ok);
+}
+
+bool reduce_many_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	// the size does not divide into the default chunks
+	const auto ints = host_values(37, 21);
+	std::vector<float> values(ints.begin(), ints.end());
+	for (auto& x : values) x -= 10;
+
+	buffer<float, 1> in{ values.data(), { 37 } };
+
+	const auto reducers = [](auto&& reduce)
+	{
+		return reduce(algorithm::reduction(0.f, std::plus<float>{}),
+			algorithm::reduction(std::numeric_limits<float>::lowest(), [](float x, float y) { return std::max(x, y); }),
+			algorithm::reduction(0, std::plus<int>{}, [](float x) { return x > 0 ? 1 : 0; }));
+	};
+
+	const auto distributed = reducers([&](auto...r) { return algorithm::reduce_many(distr<class check_reduce_many>(q), begin(in), end(in), r...).get(); });
+	const auto on_master = reducers([&](auto...r) { return algorithm::reduce_many(master_blocking(q), begin(in), end(in), r...); });
+
+	const auto expected = std::make_tuple(std::accumulate(values.begin(), values.end(), 0.f), *std::max_element(values.begin(), values.end()),
+		static_cast<int>(std::count_if(values.begin(), values.end(), [](float x) { return x > 0; })));
+
+	return report("reduce many", distributed == expected && on_master == expected);
+}
+
+bool histogram_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	// keys below and above the bins are ignored
+	const auto values = host_values(500, 23);
+	const auto key = [](int x) { return x - 1; };
+
+	std::vector<int> expected(20, 0);
+	for (const auto x : values)
+	{
+		if (key(x) >= 0 && key(x) < 20) ++expected[key(x)];
+	}
+
+	buffer<int, 1> in{ values.data(), { 500 } };
+
+	// from one chunk per element, which merges in groups of 23 rows, to a single chunk
+	auto ok = true;
+	for (const auto chunk_size : { 1, 7, 64, 500 })
+	{
+		buffer<int, 1> bins{ { 20 } };
+		algorithm::histogram(distr<class check_histogram>(q), begin(in), end(in), begin(bins), end(bins), key, cl::sycl::range<1>{ chunk_size });
+		ok = ok && host_copy(q, bins) == expected;
+	}
+
+	buffer<int, 1> default_bins{ { 20 } };
+	algorithm::histogram(distr<class check_histogram_default>(q), begin(in), end(in), begin(default_bins), end(default_bins), key);
+
+	buffer<int, 1> master_bins{ { 20 } };
+	algorithm::histogram(master_blocking(q), begin(in), end(in), begin(master_bins), end(master_bins), key);
+
+	ok = ok && host_copy(q, default_bins) == expected && host_copy(q, master_bins) == expected;
+
+	return report("histogram", ok);
+}
+
+bool transform_reduce_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	const auto a = host_values(35, 9);
+	const auto b = host_values(35, 4);
+
+	buffer<int, 2> a_buf{ a.data(), { 7, 5 } };
+	buffer<int, 1> a_flat{ a.data(), { 35 } };
+	buffer<int, 1> b_flat{ b.data(), { 35 } };
+
+	// the result type differs from the element type
+	const auto square = [](int x) { return static_cast<long long>(x) * x; };
+	const auto sum_of_squares = std::transform_reduce(a.begin(), a.end(), 5ll, std::plus<long long>{}, square);
+
+	auto distributed = algorithm::transform_reduce(distr<class check_transform_reduce>(q), begin(a_buf), end(a_buf), 5ll, std::plus<long long>{}, square);
+	const auto on_master = algorithm::transform_reduce(master_blocking(q), begin(a_buf), end(a_buf), 5ll, std::plus<long long>{}, square);
+
+	// two ranges, with the default operations and with a custom pair
+	const auto dot = std::transform_reduce(a.begin(), a.end(), b.begin(), 0);
+	const auto max_diff = std::transform_reduce(a.begin(), a.end(), b.begin(), -100, [](int x, int y) { return std::max(x, y); }, std::minus<int>{});
+
+	auto distributed_dot = algorithm::transform_reduce(distr<class check_transform_reduce_dot>(q), begin(a_flat), end(a_flat), begin(b_flat), 0);
+	auto distributed_max_diff = algorithm::transform_reduce(distr<class check_transform_reduce_max_diff>(q), begin(a_flat), end(a_flat), begin(b_flat), -100,
+		[](int x, int y) { return std::max(x, y); }, std::minus<int>{});
+
+	return report("transform reduce", distributed.get() == sum_of_squares && on_master == sum_of_squares
+		&& distributed_dot.get() == dot && distributed_max_diff.get() == max_diff);
+}
+
+// small integers, so that every sum below is exact in float
+bool spmv_checks()
+{
+	using namespace celerity;
+	using namespace algorithm;
+
+	distr_queue q;
+
+	// every third row is empty, the others have up to four entries at pseudo-random columns
+	const auto rows = 30, cols = 25;
+	const auto picks = host_values(rows * 4, cols);
+
+	std::vector<int> row_ptr{ 0 }, col_idx;
+	std::vector<float> values;
+	for (auto row = 0; row < rows; ++row)
+	{
+		if (row % 3 != 2)
+		{
+			std::vector<int> row_cols(picks.begin() + row * 4, picks.begin() + row * 4 + 1 + row % 4);
+			std::sort(row_cols.begin(), row_cols.end());
+			row_cols.erase(std::unique(row_cols.begin(), row_cols.end()), row_cols.end());
+
+			for (const auto col : row_cols)
+			{
+				col_idx.push_back(col);
+				values.push_back(static_cast<float>((row + col) % 5) - 2);
+			}
+		}
+
+		row_ptr.push_back(static_cast<int>(col_idx.size()));
+	}
+
+	const csr_matrix<float> a{ rows, cols, row_ptr, col_idx, values };
+
+	// x is a window of a larger buffer
+	std::vector<float> x_values(cols + 3);
+	for (auto i = 0; i < cols + 3; ++i) x_values[i] = static_cast<float>(i % 7) - 3;
+
+	buffer<float, 1> x{ x_values.data(), { static_cast<size_t>(cols) + 3 } };
+	buffer<float, 1> y{ { static_cast<size_t>(rows) } };
+	buffer<float, 1> y_master{ { static_cast<size_t>(rows) } };
+
+	algorithm::spmv(distr<class check_spmv>(q), a, begin(x) + 2, begin(x) + 2 + cols, begin(y));
+	algorithm::spmv(master_blocking(q), a, begin(x) + 2, begin(x) + 2 + cols, begin(y_master));
+
+	std::vector<float> expected(rows, 0.f);
+	for (auto row = 0; row < rows; ++row)
+		for (auto k = row_ptr[row]; k < row_ptr[row + 1]; ++k)
+			expected[row] += values[k] * x_values[2 + col_idx[k]];
+
+	return report("spmv", host_copy(q, y) == expected && host_copy(q, y_master) == expected);
+}
+
+// encodings against exact host values, including saturation of 32 and 64 bit fixed point
+bool encoding_checks()
+{
+	using namespace celerity::algorithm;
+
+	using q8_32 = fixed_point_encoding<8, std::int32_t>;
+	using q8_64 = fixed_point_encoding<8, std::int64_t>;
+
+	auto ok = true;
+
+	ok = ok && q8_32::encode(1.5f) == 384 && q8_32::decode(q8_32::encode(-2.25f)) == -2.25f;
+	ok = ok && q8_32::encode(1e30f) == std::numeric_limits<std::int32_t>::max();
+	ok = ok && q8_32::encode(-1e30f) == std::numeric_limits<std::int32_t>::lowest();
+	ok = ok && q8_32::encode(std::numeric_limits<float>::infinity()) == std::numeric_limits<std::int32_t>::max();
+	ok = ok && q8_32::encode(std::numeric_limits<float>::quiet_NaN()) == 0;
+
+	ok = ok && q8_64::encode(1e30f) == std::numeric_limits<std::int64_t>::max();
+	ok = ok && q8_64::encode(-1e30f) == std::numeric_limits<std::int64_t>::lowest();
+
+	ok = ok && fixed_point_encoding<4>::encode(1e6f) == std::numeric_limits<std::int16_t>::max();
+	ok = ok && static_cast<float>(float16{ 0.333251953125f }) == 0.333251953125f && static_cast<float>(float16{ 65504.f }) == 65504.f;
+
+	return report("encodings", ok);
+}
+
+int main(int argc, char* argv[]) {
 
 	sequence_static_assertions();
 	iterator_static_assertions();
 
 	sequence_examples();
 
+	if (!nd_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!slice_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!chunk_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!sort_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!linear_algebra_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!window_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!access_mode_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!runtime_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!split_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!block_split_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!scratch_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!composition_copy_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!task_graph_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!zip_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!soa_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!encoded_buffer_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!reduce_many_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!histogram_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!transform_reduce_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!spmv_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (!encoding_checks())
+	{
+		return EXIT_FAILURE;
+	}
+
+#ifdef MOCK_CELERITY_MPI
+	if (!mpi_checks())
+	{
+		return EXIT_FAILURE;
+	}
+#endif
+
 	cout << endl;
-	cin.get();
+
+	// tests run non-interactively
+	if (argc < 2 || std::string{ argv[1] } != "--no-pause")
+	{
+		cin.get();
+	}
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,316 @@
+#define MOCK_CELERITY
+// no per-element tracing of the mock accessors, it would dominate the timings
+#define MOCK_CELERITY_QUIET
+#include "../../src/algorithm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+// Mini-apps implemented with the algorithms of this library next to hand-written command groups.
+// Reports the best runtime of a few repetitions and the bandwidth of the minimal memory traffic.
+// The mock runtime (MOCK_CELERITY) reports host timings of the mock; build against Celerity for device numbers.
+
+using namespace celerity;
+using clock_type = std::chrono::steady_clock;
+
+constexpr auto REPETITIONS = 3;
+
+// discards what the mock still prints per submission while timing
+class null_buffer : public std::streambuf
+{
+protected:
+	int overflow(int c) override { return c; }
+};
+
+struct vec3
+{
+	float x, y, z;
+
+	vec3 operator+(const vec3& o) const { return { x + o.x, y + o.y, z + o.z }; }
+	vec3 operator-(const vec3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+	vec3 operator*(float s) const { return { x * s, y * s, z * s }; }
+	float dot(const vec3& o) const { return x * o.x + y * o.y + z * o.z; }
+};
+
+struct measurement
+{
+	const char* app;
+	int size;
+	double library_ms;
+	double hand_ms;
+	double bytes;
+	bool matches;
+};
+
+template<typename F>
+double best_ms(distr_queue& q, const F& f)
+{
+	auto best = 0.0;
+
+	for (auto i = 0; i < REPETITIONS; ++i)
+	{
+		q.wait();
+		const auto start = clock_type::now();
+		f();
+		q.wait();
+
+		const auto ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+
+	return best;
+}
+
+template<typename T, size_t Rank, typename Distance>
+float max_difference(distr_queue& q, buffer<T, Rank>& a, buffer<T, Rank>& b, const Distance& distance)
+{
+	return algorithm::transform_reduce(algorithm::master_blocking(q), begin(a), end(a), begin(b), 0.f,
+		[](float x, float y) { return std::max(x, y); }, distance);
+}
+
+// STREAM triad: a = b + s * c
+
+measurement triad(distr_queue& q, int n)
+{
+	constexpr auto s = 3.f;
+	const cl::sycl::range<1> r{ n };
+
+	buffer<float, 1> a{ r }, a_hand{ r }, b{ r }, c{ r };
+
+	algorithm::fill(algorithm::distr<class triad_init_b>(q), begin(b), end(b), 1.f);
+	algorithm::generate(algorithm::distr<class triad_init_c>(q), begin(c), end(c), [](cl::sycl::item<1> i) { return static_cast<float>(i[0] % 13); });
+
+	const auto library_ms = best_ms(q, [&]()
+		{
+			algorithm::transform(algorithm::distr<class triad_library>(q), begin(a), end(a), [](float x, float y) { return x + s * y; }, begin(b), begin(c));
+		});
+
+	const auto hand_ms = best_ms(q, [&]()
+		{
+			q.submit([=](handler cgh)
+				{
+					auto w_a = a_hand.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+					auto r_b = b.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+					auto r_c = c.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+
+					cgh.parallel_for<class triad_hand>(r, [&](cl::sycl::item<1> item) { w_a[item] = r_b[item] + s * r_c[item]; });
+				});
+		});
+
+	const auto difference = max_difference(q, a, a_hand, [](float x, float y) { return std::abs(x - y); });
+
+	return { "triad", n, library_ms, hand_ms, 3.0 * sizeof(float) * n, difference == 0 };
+}
+
+// wave_sim: second order wave equation on an n x n grid with a five-point stencil
+
+measurement wave(distr_queue& q, int n, int steps)
+{
+	constexpr auto c = 0.25f; // (dt / dx)^2
+	const cl::sycl::range<2> r{ n, n };
+
+	const auto gaussian = [n](cl::sycl::item<2> item)
+	{
+		const auto dx = item[1] - n / 4.f, dy = item[0] - n / 4.f, s = n / 8.f;
+		return std::exp(-(dx * dx + dy * dy) / (2 * s * s));
+	};
+
+	// the library has no stencil access, so each direction is a slice transform followed by a zip update
+	buffer<float, 2> prev{ r }, cur{ r }, next{ r }, lap_x{ r }, lap_y{ r };
+
+	const auto library_ms = best_ms(q, [&]()
+		{
+			algorithm::generate(algorithm::distr<class wave_init_cur>(q), begin(cur), end(cur), gaussian);
+			algorithm::generate(algorithm::distr<class wave_init_prev>(q), begin(prev), end(prev), gaussian);
+
+			for (auto i = 0; i < steps; ++i)
+			{
+				algorithm::transform(algorithm::distr<class wave_lap_y>(q), begin(cur), end(cur), begin(lap_y), [](algorithm::slice<float, 2> s)
+					{
+						const auto y = s.item()[0];
+						const auto u = *s;
+						return (y + 1 < s.size() ? s[y + 1] : u) - 2 * u + (y > 0 ? s[y - 1] : u);
+					}, 0);
+
+				algorithm::transform(algorithm::distr<class wave_lap_x>(q), begin(cur), end(cur), begin(lap_x), [](algorithm::slice<float, 2> s)
+					{
+						const auto x = s.item()[1];
+						const auto u = *s;
+						return (x + 1 < s.size() ? s[x + 1] : u) - 2 * u + (x > 0 ? s[x - 1] : u);
+					}, 1);
+
+				algorithm::transform(algorithm::distr<class wave_update>(q), begin(next), end(next),
+					[](float u, float up, float lx, float ly) { return 2 * u - up + c * (lx + ly); },
+					begin(cur), begin(prev), begin(lap_x), begin(lap_y));
+
+				std::swap(prev, cur);
+				std::swap(cur, next);
+			}
+		});
+
+	buffer<float, 2> up{ r }, u{ r };
+
+	const auto hand_ms = best_ms(q, [&]()
+		{
+			algorithm::generate(algorithm::distr<class wave_init_u>(q), begin(u), end(u), gaussian);
+			algorithm::generate(algorithm::distr<class wave_init_up>(q), begin(up), end(up), gaussian);
+
+			for (auto i = 0; i < steps; ++i)
+			{
+				q.submit([=](handler cgh)
+					{
+						auto rw_up = up.get_access<access_mode::read_write>(cgh, access::one_to_one<2>());
+						auto r_u = u.get_access<access_mode::read>(cgh, access::neighborhood<2>(1, 1));
+
+						cgh.parallel_for<class wave_hand>(r, [&](cl::sycl::item<2> item)
+							{
+								const auto py = item[0] < n - 1 ? item[0] + 1 : item[0];
+								const auto my = item[0] > 0 ? item[0] - 1 : item[0];
+								const auto px = item[1] < n - 1 ? item[1] + 1 : item[1];
+								const auto mx = item[1] > 0 ? item[1] - 1 : item[1];
+
+								const auto center = r_u[item];
+								const auto lap = r_u[{ py, item[1] }] - 2 * center + r_u[{ my, item[1] }]
+									+ r_u[{ item[0], px }] - 2 * center + r_u[{ item[0], mx }];
+
+								rw_up[item] = 2 * center - rw_up[item] + c * lap;
+							});
+					});
+
+				std::swap(up, u);
+			}
+		});
+
+	// both keep the latest time step in the "current" buffer
+	const auto difference = max_difference(q, cur, u, [](float x, float y) { return std::abs(x - y); });
+
+	return { "wave_sim", n, library_ms, hand_ms, 3.0 * sizeof(float) * n * n * steps, difference < 1e-4f };
+}
+
+// n-body: one all-pairs acceleration and leapfrog step
+
+measurement nbody(distr_queue& q, int n)
+{
+	constexpr auto dt = 0.01f;
+	constexpr auto softening = 0.01f;
+	const cl::sycl::range<1> r{ n };
+
+	const auto acceleration = [](const vec3& pi, const vec3& pj)
+	{
+		const auto d = pj - pi;
+		const auto inv = 1 / std::sqrt(d.dot(d) + softening);
+		return d * (inv * inv * inv);
+	};
+
+	const auto init_pos = [n](cl::sycl::item<1> i) { return vec3{ std::cos(i[0] * 0.1f), std::sin(i[0] * 0.1f), static_cast<float>(i[0]) / n }; };
+	const auto init_vel = [](cl::sycl::item<1> i) { return vec3{ 0, 0, 0 }; };
+
+	buffer<vec3, 1> pos{ r }, vel{ r }, acc{ r }, pos_next{ r }, vel_next{ r };
+
+	const auto library_ms = best_ms(q, [&]()
+		{
+			algorithm::generate(algorithm::distr<class nbody_init_pos>(q), begin(pos), end(pos), init_pos);
+			algorithm::generate(algorithm::distr<class nbody_init_vel>(q), begin(vel), end(vel), init_vel);
+
+			algorithm::transform(algorithm::distr<class nbody_acceleration>(q), begin(pos), end(pos), begin(acc), [=](algorithm::slice<vec3, 1> s)
+				{
+					const auto pi = *s;
+
+					vec3 a{ 0, 0, 0 };
+					for (auto j = 0; j < s.size(); ++j) a = a + acceleration(pi, s[j]);
+					return a;
+				}, 0);
+
+			algorithm::transform(algorithm::distr<class nbody_velocity>(q), begin(vel_next), end(vel_next), [](vec3 v, vec3 a) { return v + a * dt; }, begin(vel), begin(acc));
+			algorithm::transform(algorithm::distr<class nbody_position>(q), begin(pos_next), end(pos_next), [](vec3 p, vec3 v) { return p + v * dt; }, begin(pos), begin(vel_next));
+		});
+
+	buffer<vec3, 1> pos_hand{ r }, vel_hand{ r }, pos_hand_next{ r }, vel_hand_next{ r };
+
+	const auto hand_ms = best_ms(q, [&]()
+		{
+			algorithm::generate(algorithm::distr<class nbody_init_pos_hand>(q), begin(pos_hand), end(pos_hand), init_pos);
+			algorithm::generate(algorithm::distr<class nbody_init_vel_hand>(q), begin(vel_hand), end(vel_hand), init_vel);
+
+			q.submit([=](handler cgh)
+				{
+					auto r_pos = pos_hand.get_access<access_mode::read>(cgh, access::fixed<1>({ { 0 }, r }));
+					auto r_vel = vel_hand.get_access<access_mode::read>(cgh, access::one_to_one<1>());
+					auto w_pos = pos_hand_next.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+					auto w_vel = vel_hand_next.get_access<access_mode::discard_write>(cgh, access::one_to_one<1>());
+
+					cgh.parallel_for<class nbody_hand>(r, [&](cl::sycl::item<1> item)
+						{
+							const auto pi = r_pos[item];
+
+							vec3 a{ 0, 0, 0 };
+							for (auto j = 0; j < n; ++j) a = a + acceleration(pi, r_pos[{ j }]);
+
+							const auto v = r_vel[item] + a * dt;
+							w_vel[item] = v;
+							w_pos[item] = pi + v * dt;
+						});
+				});
+		});
+
+	const auto difference = max_difference(q, pos_next, pos_hand_next, [](const vec3& x, const vec3& y) { const auto d = x - y; return std::sqrt(d.dot(d)); });
+
+	// positions of all bodies are read by every body, but only have to be moved once
+	return { "nbody", n, library_ms, hand_ms, 4.0 * sizeof(vec3) * n, difference < 1e-5f };
+}
+
+int main(int argc, char* argv[]) {
+	auto verification_passed = true;
+
+	try {
+		distr_queue queue;
+
+		null_buffer null;
+		auto* const out = std::cout.rdbuf(&null);
+
+		std::vector<measurement> results;
+
+		for (const auto n : { 1 << 10, 1 << 14 }) results.push_back(triad(queue, n));
+		for (const auto n : { 32, 64 }) results.push_back(wave(queue, n, 4));
+		for (const auto n : { 128, 256 }) results.push_back(nbody(queue, n));
+
+		std::cout.rdbuf(out);
+
+		std::cout << std::left << std::setw(10) << "app" << std::right << std::setw(8) << "size"
+			<< std::setw(14) << "library ms" << std::setw(14) << "hand ms" << std::setw(14) << "library GB/s" << std::setw(14) << "hand GB/s" << std::endl;
+
+		for (const auto& m : results)
+		{
+			std::cout << std::left << std::setw(10) << m.app << std::right << std::setw(8) << m.size << std::fixed << std::setprecision(3)
+				<< std::setw(14) << m.library_ms << std::setw(14) << m.hand_ms
+				<< std::setw(14) << m.bytes / m.library_ms * 1e-6 << std::setw(14) << m.bytes / m.hand_ms * 1e-6
+				<< (m.matches ? "" : "  MISMATCH") << std::endl;
+
+			verification_passed = verification_passed && m.matches;
+		}
+
+		std::cout << "## RESULT: ";
+		if (verification_passed) {
+			std::cout << "Success! Library and hand-written results match." << std::endl;
+		}
+		else {
+			std::cout << "Fail! Library and hand-written results differ." << std::endl;
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	catch (cl::sycl::exception& e) {
+		std::cerr << "SYCL Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return verification_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,297 @@
+#define MOCK_CELERITY
+// no per-element tracing of the mock accessors, it would dominate the timings
+#define MOCK_CELERITY_QUIET
+#include "../../src/algorithm.h"
+#include "../../src/histogram.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Strong and weak scaling runs of a benchmark built on this library, written as CSV to stdout.
+//
+//   scaling [--benchmark transform|transform_reduce|histogram] [--size n] [--max p] [--batches b] [--mpirun cmd]
+//
+// The harness starts itself once per configuration ("--run"), because the mock runtime takes its
+// number of workers from MOCK_CELERITY_WORKERS at startup. Built with MOCK_CELERITY_MPI it varies the
+// number of local ranks launched with mpirun instead of the workers. Strong scaling keeps size fixed,
+// weak scaling grows it with the number of workers (or ranks). The mock splits every parallel_for
+// across its workers and executes independent command groups concurrently; every benchmark submits b
+// independent pipelines.
+//
+// Besides the wall time, each run reports its critical path: the CPU time of the busiest worker,
+// which is the time the run takes with a core per worker. The two agree on a machine with enough
+// cores, on fewer cores only the critical path shows how evenly the work is spread. Ranks execute
+// command groups themselves, so their critical path is their wall time.
+
+using namespace celerity;
+using clock_type = std::chrono::steady_clock;
+
+constexpr auto REPETITIONS = 3;
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+// discards what the mock still prints per submission while timing
+class null_buffer : public std::streambuf
+{
+protected:
+	int overflow(int c) override { return c; }
+};
+
+struct options
+{
+	std::string benchmark = "transform";
+	int size = 1 << 12;
+	int max = 4;
+	int batches = 8;
+	std::string mpirun = "mpirun";
+	bool run = false;
+};
+
+options parse(int argc, char* argv[])
+{
+	options o;
+
+	for (auto i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const auto value = [&]() { if (i + 1 >= argc) throw std::invalid_argument("missing value for " + arg); return std::string{ argv[++i] }; };
+
+		if (arg == "--benchmark") o.benchmark = value();
+		else if (arg == "--size") o.size = std::stoi(value());
+		else if (arg == "--max") o.max = std::stoi(value());
+		else if (arg == "--batches") o.batches = std::stoi(value());
+		else if (arg == "--mpirun") o.mpirun = value();
+		else if (arg == "--run") o.run = true;
+		else throw std::invalid_argument("unknown argument " + arg);
+	}
+
+	return o;
+}
+
+struct timing
+{
+	double wall_ms;
+	double critical_ms;
+};
+
+// benchmarks: prepare buffers and return the timed submissions
+
+template<typename F>
+timing best_ms(distr_queue& q, const F& f)
+{
+	auto& rt = detail::runtime::instance();
+	timing best{};
+
+	for (auto i = 0; i < REPETITIONS; ++i)
+	{
+		q.wait();
+		rt.take_busy_seconds();
+
+		const auto start = clock_type::now();
+		f();
+		q.wait();
+
+		const auto ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+		const auto busy = rt.take_busy_seconds();
+		const auto critical_ms = busy.empty() ? ms : *std::max_element(busy.begin(), busy.end()) * 1000;
+
+		best.wall_ms = i == 0 ? ms : std::min(best.wall_ms, ms);
+		best.critical_ms = i == 0 ? critical_ms : std::min(best.critical_ms, critical_ms);
+	}
+
+	return best;
+}
+
+timing run_transform(distr_queue& q, int n, int batches)
+{
+	std::vector<buffer<float, 1>> a, b, c;
+
+	for (auto i = 0; i < batches; ++i)
+	{
+		a.emplace_back(cl::sycl::range<1>{ n });
+		b.emplace_back(cl::sycl::range<1>{ n });
+		c.emplace_back(cl::sycl::range<1>{ n });
+
+		algorithm::fill(algorithm::distr<class scaling_transform_init_b>(q), begin(b[i]), end(b[i]), 1.f);
+		algorithm::fill(algorithm::distr<class scaling_transform_init_c>(q), begin(c[i]), end(c[i]), 2.f);
+	}
+
+	return best_ms(q, [&]()
+		{
+			for (auto i = 0; i < batches; ++i)
+			{
+				algorithm::transform(algorithm::distr<class scaling_transform>(q), begin(a[i]), end(a[i]), [](float x, float y) { return x + 3 * y; }, begin(b[i]), begin(c[i]));
+			}
+		});
+}
+
+timing run_transform_reduce(distr_queue& q, int n, int batches)
+{
+	std::vector<buffer<float, 1>> a, b;
+
+	for (auto i = 0; i < batches; ++i)
+	{
+		a.emplace_back(cl::sycl::range<1>{ n });
+		b.emplace_back(cl::sycl::range<1>{ n });
+
+		algorithm::fill(algorithm::distr<class scaling_reduce_init_a>(q), begin(a[i]), end(a[i]), 1.f);
+		algorithm::fill(algorithm::distr<class scaling_reduce_init_b>(q), begin(b[i]), end(b[i]), 2.f);
+	}
+
+	return best_ms(q, [&]()
+		{
+			for (auto i = 0; i < batches; ++i)
+			{
+				algorithm::transform_reduce(algorithm::distr<class scaling_reduce>(q), begin(a[i]), end(a[i]), begin(b[i]), 0.f);
+			}
+		});
+}
+
+timing run_histogram(distr_queue& q, int n, int batches)
+{
+	constexpr auto bins = 16;
+
+	std::vector<buffer<int, 1>> in, counts;
+
+	for (auto i = 0; i < batches; ++i)
+	{
+		in.emplace_back(cl::sycl::range<1>{ n });
+		counts.emplace_back(cl::sycl::range<1>{ bins });
+
+		algorithm::generate(algorithm::distr<class scaling_histogram_init>(q), begin(in[i]), end(in[i]), [](cl::sycl::item<1> item) { return (item[0] * 7) % bins; });
+	}
+
+	return best_ms(q, [&]()
+		{
+			for (auto i = 0; i < batches; ++i)
+			{
+				algorithm::histogram(algorithm::distr<class scaling_histogram>(q), begin(in[i]), end(in[i]), begin(counts[i]), end(counts[i]), [](int x) { return x; });
+			}
+		});
+}
+
+// runs one configuration in this process and prints its time
+int run(const options& o)
+{
+	const std::map<std::string, timing(*)(distr_queue&, int, int)> benchmarks{
+		{ "transform", run_transform },
+		{ "transform_reduce", run_transform_reduce },
+		{ "histogram", run_histogram },
+	};
+
+	const auto benchmark = benchmarks.find(o.benchmark);
+	if (benchmark == benchmarks.end()) throw std::invalid_argument("unknown benchmark " + o.benchmark);
+
+	distr_queue queue;
+
+	null_buffer null;
+	auto* const out = std::cout.rdbuf(&null);
+
+	const auto t = benchmark->second(queue, o.size, o.batches);
+
+	std::cout.rdbuf(out);
+
+	// every rank prints its times, the harness takes the slowest
+	std::cout << "time_ms " << t.wall_ms << " critical_ms " << t.critical_ms << std::endl;
+
+	return EXIT_SUCCESS;
+}
+
+void set_workers(int workers)
+{
+	const auto value = std::to_string(workers);
+#ifdef _WIN32
+	_putenv_s("MOCK_CELERITY_WORKERS", value.c_str());
+#else
+	setenv("MOCK_CELERITY_WORKERS", value.c_str(), 1);
+#endif
+}
+
+// starts this program for one configuration and returns the times of its slowest rank
+timing launch(const std::string& self, const options& o, int size, int ranks)
+{
+	auto command = "\"" + self + "\" --run --benchmark " + o.benchmark + " --size " + std::to_string(size) + " --batches " + std::to_string(o.batches);
+
+#ifdef MOCK_CELERITY_MPI
+	command = o.mpirun + " -np " + std::to_string(ranks) + " " + command;
+#endif
+
+	const auto pipe = popen(command.c_str(), "r");
+	if (!pipe) throw std::runtime_error("failed to start " + command);
+
+	timing slowest{ -1, -1 };
+	char line[256];
+
+	while (std::fgets(line, sizeof(line), pipe))
+	{
+		if (timing t; std::sscanf(line, "time_ms %lf critical_ms %lf", &t.wall_ms, &t.critical_ms) == 2)
+		{
+			slowest.wall_ms = std::max(slowest.wall_ms, t.wall_ms);
+			slowest.critical_ms = std::max(slowest.critical_ms, t.critical_ms);
+		}
+	}
+
+	if (pclose(pipe) != 0 || slowest.wall_ms < 0) throw std::runtime_error("benchmark run failed: " + command);
+
+	return slowest;
+}
+
+int main(int argc, char* argv[]) {
+	try {
+		const auto o = parse(argc, argv);
+
+		if (o.run) return run(o);
+
+		std::cout << "benchmark,scaling,ranks,workers,size,time_ms,speedup,efficiency,critical_ms,critical_speedup" << std::endl;
+
+		for (const auto weak : { false, true })
+		{
+			timing base{};
+
+			for (auto p = 1; p <= o.max; p *= 2)
+			{
+#ifdef MOCK_CELERITY_MPI
+				// ranks execute command groups on submission, workers are not used
+				const auto ranks = p, workers = 0;
+#else
+				const auto ranks = 1, workers = p;
+#endif
+				set_workers(workers);
+
+				const auto size = weak ? o.size * p : o.size;
+				const auto t = launch(argv[0], o, size, ranks);
+
+				if (p == 1) base = t;
+
+				// weak scaling reports the scaled speedup, p times the work in the same time is ideal
+				const auto scale = weak ? p : 1;
+				const auto speedup = base.wall_ms / t.wall_ms * scale;
+				const auto efficiency = speedup / p;
+				const auto critical_speedup = base.critical_ms / t.critical_ms * scale;
+
+				std::cout << o.benchmark << "," << (weak ? "weak" : "strong") << "," << ranks << "," << workers << "," << size << ","
+					<< t.wall_ms << "," << speedup << "," << efficiency << "," << t.critical_ms << "," << critical_speedup << std::endl;
+			}
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	catch (cl::sycl::exception& e) {
+		std::cerr << "SYCL Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
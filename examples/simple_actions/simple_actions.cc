@@ -63,6 +63,19 @@ int main(int argc, char* argv[]) {
 			on_master(verify(produce_a | compute_b | compute_c | compute_d | reduce_d | submit_to(queue)));
 		}
 
+		// d = b + c is reduced in the kernel that computes it, buf_d is not needed
+
+		{
+			auto sum_future =
+				actions::fill(distr<class produce_a>(queue), begin(buf_a), end(buf_a), []() { return 1.f; }) |
+				actions::transform(distr<class compute_b>(queue), begin(buf_a), end(buf_a), begin(buf_b), [](float x) { return 2.f * x; }) |
+				actions::transform(master(queue), begin(buf_a), end(buf_a), begin(buf_c), [](const float x) { return 2.f - x; }) |
+				actions::transform_reduce(distr<class reduce_b_c>(queue), begin(buf_b), end(buf_b), begin(buf_c), 0.0f, std::plus<float>{}, [](const float x, const float y) { return x + y; }) |
+				submit_to(queue);
+
+			on_master(verify(std::move(sum_future)));
+		}
+
 	}
 	catch (std::exception& e) {
 		std::cerr << "Exception: " << e.what() << std::endl;
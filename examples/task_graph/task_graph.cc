@@ -0,0 +1,98 @@
+#define MOCK_CELERITY
+#include "../../src/algorithm.h"
+#include "../../src/actions.h"
+
+#include <chrono>
+#include <iostream>
+#include <streambuf>
+
+constexpr auto DEMO_DATA_SIZE = 4;
+constexpr auto ITERATIONS = 200;
+
+// discards everything the mock prints while timing
+class null_buffer : public std::streambuf
+{
+protected:
+	int overflow(int c) override { return c; }
+};
+
+int main(int argc, char* argv[]) {
+	auto verification_passed = true;
+
+	using namespace celerity;
+	using clock = std::chrono::steady_clock;
+
+	try {
+		distr_queue queue;
+
+		buffer<float, 1> buf_a(cl::sycl::range<1>{DEMO_DATA_SIZE});
+		buffer<float, 1> buf_b(cl::sycl::range<1>{DEMO_DATA_SIZE});
+
+		null_buffer null;
+		auto* const out = std::cout.rdbuf(&null);
+
+		algorithm::fill(algorithm::distr<class init_a>(queue), begin(buf_a), end(buf_a), 0.f);
+
+		// built and submitted from scratch every iteration
+		const auto step = [&](float dt)
+		{
+			algorithm::actions::transform(algorithm::distr<class advance>(queue), begin(buf_a), end(buf_a), begin(buf_b), [dt](float x) { return x + dt; }) |
+				algorithm::actions::transform(algorithm::distr<class relax>(queue), begin(buf_b), end(buf_b), begin(buf_a), [](float x) { return 0.5f * x; }) |
+				algorithm::submit_to(queue);
+		};
+
+		// submission cost only, kernels may still execute on the mock's worker threads afterwards
+		const auto per_iteration = [](clock::time_point start, int iterations) { return std::chrono::duration<double, std::micro>(clock::now() - start).count() / iterations; };
+
+		queue.wait();
+		auto start = clock::now();
+		for (auto i = 0; i < ITERATIONS; ++i) step(static_cast<float>(i));
+		const auto rebuilt = per_iteration(start, ITERATIONS);
+
+		const auto sum = [&]() { return algorithm::accumulate(algorithm::master_blocking(queue), begin(buf_a), end(buf_a), 0.0f, [](float acc, float x) { return acc + x; }); };
+		const auto expected = sum();
+
+		// recorded once, replayed with a new time step every iteration
+		algorithm::fill(algorithm::distr<class init_a>(queue), begin(buf_a), end(buf_a), 0.f);
+
+		algorithm::parameter<float> dt;
+		const auto graph = algorithm::record(queue, [&](distr_queue q)
+			{
+				algorithm::actions::transform(algorithm::distr<class advance>(q), begin(buf_a), end(buf_a), begin(buf_b), [dt](float x) { return x + dt.get(); }) |
+					algorithm::actions::transform(algorithm::distr<class relax>(q), begin(buf_b), end(buf_b), begin(buf_a), [](float x) { return 0.5f * x; }) |
+					algorithm::submit_to(q);
+			});
+
+		queue.wait();
+		start = clock::now();
+		for (auto i = 1; i < ITERATIONS; ++i) graph.replay(queue, dt.bind(static_cast<float>(i)));
+		const auto replayed = per_iteration(start, ITERATIONS - 1);
+
+		const auto actual = sum();
+
+		std::cout.rdbuf(out);
+
+		std::cout << "tasks per iteration: " << graph.size() << std::endl;
+		std::cout << "rebuilt:  " << rebuilt << " us submission per iteration" << std::endl;
+		std::cout << "replayed: " << replayed << " us submission per iteration" << std::endl;
+
+		std::cout << "## RESULT: ";
+		if (actual == expected) {
+			std::cout << "Success! Correct value was computed." << std::endl;
+		}
+		else {
+			std::cout << "Fail! Value is " << actual << ", expected " << expected << std::endl;
+			verification_passed = false;
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << "Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	catch (cl::sycl::exception& e) {
+		std::cerr << "SYCL Exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return verification_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
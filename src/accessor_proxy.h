@@ -2,6 +2,12 @@
 #define ACCESSOR_PROXY_H
 
 #include "celerity.h"
+#include "iterator.h"
+#include "policy.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <utility>
 
 namespace celerity::algorithm
 {
@@ -15,8 +21,23 @@ namespace celerity::algorithm
 
 	namespace detail
 	{
+		// Reads elements through the accessor of a slice proxy. Refers to the accessor instead of
+		// owning a copy, so slices are cheap to create per item and never allocate.
 		template<typename T, size_t Rank>
-		using getter_t = std::function<T(cl::sycl::item<Rank>)>;
+		class getter_t
+		{
+		public:
+			template<typename Accessor>
+			explicit getter_t(const Accessor& acc)
+				: acc_(&acc), get_([](const void* acc, cl::sycl::item<Rank> item) -> T { return (*static_cast<const Accessor*>(acc))[item]; })
+			{}
+
+			T operator()(cl::sycl::item<Rank> item) const { return get_(acc_, item); }
+
+		private:
+			const void* acc_;
+			T(*get_)(const void*, cl::sycl::item<Rank>);
+		};
 	}
 
 	template<typename T>
@@ -29,20 +50,35 @@ namespace celerity::algorithm
 	class slice
 	{
 	public:
-		slice(cl::sycl::item<Rank> item, const detail::getter_t<T, Rank>& f)
-			: item_(item), getter_(f)
+		slice(cl::sycl::item<Rank> item, size_t dim, int size, detail::getter_t<T, Rank> f)
+			: item_(item), dim_(dim), size_(size), getter_(f)
 		{}
 
 		const cl::sycl::item<Rank>& item() const { return item_; }
+		size_t dim() const { return dim_; }
+		int size() const { return size_; }
+
 		T operator*() const
 		{
 			return getter_(item_);
 		}
-		T operator[](cl::sycl::item<Rank> pos) const { return getter_(pos); }
+
+		// element at position pos along the slice dimension
+		T operator[](int pos) const
+		{
+			assert(pos >= 0 && pos < size_);
+
+			auto item = item_;
+			item[dim_] = pos;
+
+			return getter_(item);
+		}
 
 	private:
 		cl::sycl::item<Rank> item_;
-		const detail::getter_t<T, Rank>& getter_;
+		size_t dim_;
+		int size_;
+		detail::getter_t<T, Rank> getter_;
 	};
 	
 	template<typename T, size_t Rank>
@@ -52,10 +88,128 @@ namespace celerity::algorithm
 	struct is_chunk : public std::false_type {};
 
 	template<typename T>
-	inline constexpr auto is_chunk_v = is_slice<T>::value;
+	inline constexpr auto is_chunk_v = is_chunk<T>::value;
+
+	// Iterates over the elements of an N-D chunk in row-major order. The chunk does not have
+	// to span whole rows of its buffer, every step skips to the next row of the chunk as needed.
+	template<typename T, size_t Rank>
+	class chunk_iterator
+	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::remove_cv_t<T>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		chunk_iterator() = default;
+
+		chunk_iterator(T* data, cl::sycl::id<Rank> offset, cl::sycl::range<Rank> range, cl::sycl::range<Rank> buffer_range, difference_type pos)
+			: data_(data), offset_(offset), range_(range), buffer_range_(buffer_range), pos_(pos)
+		{}
+
+		reference operator*() const { return (*this)[0]; }
+		pointer operator->() const { return &**this; }
+
+		reference operator[](difference_type n) const
+		{
+			auto idx = detail::delinearize(static_cast<int>(pos_ + n), range_);
+
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				idx[i] += offset_[i];
+			}
+
+			return data_[detail::linearize(idx, buffer_range_)];
+		}
+
+		chunk_iterator& operator+=(difference_type n) { pos_ += n; return *this; }
+		chunk_iterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+		chunk_iterator& operator++() { ++pos_; return *this; }
+		chunk_iterator& operator--() { --pos_; return *this; }
+		chunk_iterator operator++(int) { auto it = *this; ++pos_; return it; }
+		chunk_iterator operator--(int) { auto it = *this; --pos_; return it; }
+
+		chunk_iterator operator+(difference_type n) const { return chunk_iterator{ *this } += n; }
+		chunk_iterator operator-(difference_type n) const { return chunk_iterator{ *this } -= n; }
+		friend chunk_iterator operator+(difference_type n, const chunk_iterator& it) { return it + n; }
+
+		difference_type operator-(const chunk_iterator& rhs) const { return pos_ - rhs.pos_; }
+
+		bool operator==(const chunk_iterator& rhs) const { return pos_ == rhs.pos_; }
+		bool operator!=(const chunk_iterator& rhs) const { return pos_ != rhs.pos_; }
+		bool operator<(const chunk_iterator& rhs) const { return pos_ < rhs.pos_; }
+		bool operator>(const chunk_iterator& rhs) const { return pos_ > rhs.pos_; }
+		bool operator<=(const chunk_iterator& rhs) const { return pos_ <= rhs.pos_; }
+		bool operator>=(const chunk_iterator& rhs) const { return pos_ >= rhs.pos_; }
+
+	private:
+		T* data_ = nullptr;
+		cl::sycl::id<Rank> offset_{};
+		cl::sycl::range<Rank> range_{};
+		cl::sycl::range<Rank> buffer_range_{};
+		difference_type pos_ = 0;
+	};
 
 	template<typename T, size_t Rank>
-	struct chunk {};
+	class chunk
+	{
+	public:
+		chunk(T* data, cl::sycl::id<Rank> offset, cl::sycl::range<Rank> range, cl::sycl::range<Rank> buffer_range)
+			: data_(data), offset_(offset), range_(range), buffer_range_(buffer_range)
+		{}
+
+		// offset of the first element of the chunk within the buffer
+		const cl::sycl::id<Rank>& offset() const { return offset_; }
+		const cl::sycl::range<Rank>& range() const { return range_; }
+		int size() const { return detail::count(range_); }
+
+		// a chunk is contiguous in memory if it spans whole rows
+		bool contiguous() const
+		{
+			for (size_t i = 1; i < Rank; ++i)
+			{
+				if (range_[i] != buffer_range_[i]) return false;
+			}
+			return true;
+		}
+
+		// element at position pos relative to the offset of the chunk
+		T& operator[](cl::sycl::id<Rank> pos) const
+		{
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				assert(pos[i] >= 0 && pos[i] < range_[i]);
+				pos[i] += offset_[i];
+			}
+
+			return data_[detail::linearize(pos, buffer_range_)];
+		}
+
+		// 1-D chunks are always contiguous and iterate over plain pointers
+		using iterator = std::conditional_t<Rank == 1, T*, chunk_iterator<T, Rank>>;
+
+		iterator begin() const { return make_iterator(0); }
+		iterator end() const { return make_iterator(size()); }
+
+	private:
+		iterator make_iterator(int pos) const
+		{
+			if constexpr (Rank == 1)
+			{
+				return data_ + offset_[0] + pos;
+			}
+			else
+			{
+				return iterator{ data_, offset_, range_, buffer_range_, pos };
+			}
+		}
+
+		T* data_;
+		cl::sycl::id<Rank> offset_;
+		cl::sycl::range<Rank> range_;
+		cl::sycl::range<Rank> buffer_range_;
+	};
 
 	template<typename T, size_t Rank>
 	struct is_chunk<chunk<T, Rank>> : public std::true_type {};
@@ -114,6 +268,102 @@ namespace celerity::algorithm
 		{
 			return access_type::invalid;
 		}
+
+		// true if F takes exactly one element per index of Is
+		template<typename F, size_t...Is>
+		constexpr bool takes_elements(std::index_sequence<Is...>)
+		{
+			if constexpr (!has_call_operator_v<F>)
+			{
+				return false;
+			}
+			else if constexpr (function_traits<F>::arity != sizeof...(Is))
+			{
+				return false;
+			}
+			else
+			{
+				return ((get_accessor_type<F, static_cast<int>(Is)>() == access_type::one_to_one) && ...);
+			}
+		}
+
+		// Maps a chunk of the kernel index space to the same elements shifted by offset.
+		// The subrange is clipped to the buffer, so a shift past either edge of the
+		// buffer (a negative offset included) only requests the elements that exist.
+		template<size_t Rank>
+		struct offset_range_mapper
+		{
+			cl::sycl::id<Rank> offset;
+			cl::sycl::range<Rank> buffer_range;
+
+			subrange<Rank> operator()(celerity::chunk<Rank> chnk) const
+			{
+				subrange<Rank> sr{ chnk.offset, chnk.range };
+
+				for (size_t i = 0; i < Rank; ++i)
+				{
+					const auto first = std::clamp(chnk.offset[i] + offset[i], 0, buffer_range[i]);
+					const auto last = std::clamp(chnk.offset[i] + offset[i] + chnk.range[i], 0, buffer_range[i]);
+
+					sr.offset[i] = first;
+					sr.range[i] = last - first;
+				}
+
+				return sr;
+			}
+		};
+
+		// Like offset_range_mapper, but spans the whole buffer along the slice dimension
+		template<size_t Rank>
+		struct slice_range_mapper
+		{
+			cl::sycl::id<Rank> offset;
+			size_t dim;
+			cl::sycl::range<Rank> buffer_range;
+
+			subrange<Rank> operator()(celerity::chunk<Rank> chnk) const
+			{
+				auto sr = offset_range_mapper<Rank>{ offset, buffer_range }(chnk);
+				sr.offset[dim] = 0;
+				sr.range[dim] = buffer_range[dim];
+				return sr;
+			}
+		};
+
+		template<size_t Rank>
+		cl::sycl::item<Rank> shift(cl::sycl::item<Rank> item, const cl::sycl::id<Rank>& offset)
+		{
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				item[i] += offset[i];
+			}
+			return item;
+		}
+
+		// Maps a chunk of the chunk index space to the elements covered by those chunks
+		template<size_t Rank>
+		struct chunk_range_mapper
+		{
+			cl::sycl::id<Rank> offset;
+			cl::sycl::range<Rank> range;
+			cl::sycl::range<Rank> chunk_size;
+
+			subrange<Rank> operator()(celerity::chunk<Rank> chnk) const
+			{
+				subrange<Rank> sr{ offset, range };
+
+				for (size_t i = 0; i < Rank; ++i)
+				{
+					const auto first = chnk.offset[i] * chunk_size[i];
+					const auto last = std::min((chnk.offset[i] + chnk.range[i]) * chunk_size[i], range[i]);
+
+					sr.offset[i] += first;
+					sr.range[i] = last - first;
+				}
+
+				return sr;
+			}
+		};
 	}
 
 	template<typename T, size_t Rank, typename AccessorType, access_type Type>
@@ -123,53 +373,167 @@ namespace celerity::algorithm
 	class accessor_proxy<T, Rank, AccessorType, access_type::one_to_one>
 	{
 	public:
-		explicit accessor_proxy(AccessorType acc) : accessor_(acc) {}
+		accessor_proxy(AccessorType acc, cl::sycl::id<Rank> offset) : accessor_(acc), offset_(offset) {}
 
-		T operator[](const cl::sycl::item<Rank> item) const { return accessor_[item]; }
-		T& operator[](const cl::sycl::item<Rank> item) { return accessor_[item]; }
+		// item is relative to the offset of the accessed range
+		T operator[](const cl::sycl::item<Rank> item) const { return accessor_[detail::shift(item, offset_)]; }
+		T& operator[](const cl::sycl::item<Rank> item) { return accessor_[detail::shift(item, offset_)]; }
 
 	private:
 		AccessorType accessor_;
+		cl::sycl::id<Rank> offset_;
 	};
 
 	template<typename T, size_t Rank, typename AccessorType>
 	class accessor_proxy<T, Rank, AccessorType, access_type::slice>
 	{
 	public:
-		explicit accessor_proxy(AccessorType acc) 
-			: accessor_(acc), getter_([this](cl::sycl::item<Rank> i) { return accessor_[i]; }) {}
+		accessor_proxy(AccessorType acc, cl::sycl::id<Rank> offset, size_t dim, int size)
+			: accessor_(acc), offset_(offset), dim_(dim), size_(size) {}
 
+		// the slice addresses absolute positions along its dimension
 		slice<T, Rank> operator[](const cl::sycl::item<Rank> it) const
 		{
-			return slice<T, Rank>{ it, getter_ };
+			return slice<T, Rank>{ detail::shift(it, offset_), dim_, size_, detail::getter_t<T, Rank>{ accessor_ } };
 		}
 
 	private:
-		detail::getter_t<T, Rank> getter_;
 		AccessorType accessor_;
+		cl::sycl::id<Rank> offset_;
+		size_t dim_;
+		int size_;
 	};
 
 	template<typename T, size_t Rank, typename AccessorType>
 	class accessor_proxy<T, Rank, AccessorType, access_type::chunk>
 	{
 	public:
-		explicit accessor_proxy(AccessorType acc) : accessor_(acc) {}
+		accessor_proxy(AccessorType acc, cl::sycl::id<Rank> offset, cl::sycl::range<Rank> range, cl::sycl::range<Rank> chunk_size, cl::sycl::range<Rank> buffer_range)
+			: accessor_(acc), offset_(offset), range_(range), chunk_size_(chunk_size), buffer_range_(buffer_range) {}
 
-		chunk<T, Rank> operator[](const cl::sycl::item<Rank>) const { return {}; }
+		// item indexes the chunk, not the element
+		chunk<T, Rank> operator[](const cl::sycl::item<Rank> item) const
+		{
+			auto offset = offset_;
+			auto range = chunk_size_;
+
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				const auto first = item[i] * chunk_size_[i];
+
+				offset[i] += first;
+				range[i] = std::min(chunk_size_[i], range_[i] - first);
+			}
+
+			return chunk<T, Rank>{ accessor_.get_pointer(), offset, range, buffer_range_ };
+		}
 
 	private:
 		AccessorType accessor_;
+		cl::sycl::id<Rank> offset_;
+		cl::sycl::range<Rank> range_;
+		cl::sycl::range<Rank> chunk_size_;
+		cl::sycl::range<Rank> buffer_range_;
 	};
 
-	template<celerity::access_mode Mode, access_type Type, typename T, size_t Rank>
-	auto get_access(celerity::handler cgh, iterator<T, Rank> beg, iterator<T, Rank> end)
+	template<typename ExecutionPolicy, celerity::access_mode Mode, access_type Type, typename T, size_t Rank>
+	auto get_access(celerity::handler cgh, iterator<T, Rank> beg, cl::sycl::range<Rank> r)
+	{
+		static_assert(Type == access_type::one_to_one, "access type requires additional parameters");
+
+		task_profile::record_access<Mode, T>(r);
+
+		if constexpr (policy_traits<std::decay_t<ExecutionPolicy>>::is_distributed)
+		{
+			auto acc = beg.buffer().template get_access<Mode>(cgh, detail::offset_range_mapper<Rank>{ *beg, beg.buffer().get_range() });
+
+			return accessor_proxy<T, Rank, decltype(acc), Type>{ acc, *beg };
+		}
+		else
+		{
+			auto acc = beg.buffer().template get_access<Mode>(cgh, r, *beg);
+
+			return accessor_proxy<T, Rank, decltype(acc), Type>{ acc, *beg };
+		}
+	}
+
+	template<typename ExecutionPolicy, celerity::access_mode Mode, access_type Type, typename T, size_t Rank>
+	auto get_access(celerity::handler cgh, iterator<T, Rank> beg, cl::sycl::range<Rank> r, size_t slice_dim)
+	{
+		static_assert(Type == access_type::slice, "slice dimension requires slice access");
+		assert(slice_dim < Rank);
+
+		const auto size = beg.buffer().get_range()[slice_dim];
+
+		auto slice_range = r;
+		slice_range[slice_dim] = size;
+		task_profile::record_access<Mode, T>(slice_range);
+
+		if constexpr (policy_traits<std::decay_t<ExecutionPolicy>>::is_distributed)
+		{
+			auto acc = beg.buffer().template get_access<Mode>(cgh, detail::slice_range_mapper<Rank>{ *beg, slice_dim, beg.buffer().get_range() });
+
+			return accessor_proxy<T, Rank, decltype(acc), Type>{ acc, *beg, slice_dim, size };
+		}
+		else
+		{
+			auto offset = *beg;
+			offset[slice_dim] = 0;
+
+			auto acc = beg.buffer().template get_access<Mode>(cgh, slice_range, offset);
+
+			return accessor_proxy<T, Rank, decltype(acc), Type>{ acc, *beg, slice_dim, size };
+		}
+	}
+
+	template<typename ExecutionPolicy, celerity::access_mode Mode, access_type Type, typename T, size_t Rank>
+	auto get_access(celerity::handler cgh, iterator<T, Rank> beg, cl::sycl::range<Rank> r, cl::sycl::range<Rank> chunk_size)
 	{
-		assert(&beg.buffer() == &end.buffer());
-		assert(*beg <= *end);
+		static_assert(Type == access_type::chunk, "chunk size requires chunk access");
 
-		auto acc = beg.buffer().get_access<Mode>(cgh, cl::sycl::range<1>{ *end - *beg });
+		const auto buffer_range = beg.buffer().get_range();
+
+		task_profile::record_access<Mode, T>(r);
+
+		if constexpr (policy_traits<std::decay_t<ExecutionPolicy>>::is_distributed)
+		{
+			auto acc = beg.buffer().template get_access<Mode>(cgh, detail::chunk_range_mapper<Rank>{ *beg, r, chunk_size });
+
+			return accessor_proxy<T, Rank, decltype(acc), Type>{ acc, *beg, r, chunk_size, buffer_range };
+		}
+		else
+		{
+			auto acc = beg.buffer().template get_access<Mode>(cgh, r, *beg);
+
+			return accessor_proxy<T, Rank, decltype(acc), Type>{ acc, *beg, r, chunk_size, buffer_range };
+		}
+	}
+
+	template<typename ExecutionPolicy, celerity::access_mode Mode, access_type Type, typename T, size_t Rank, typename...Args>
+	auto get_access(celerity::handler cgh, iterator<T, Rank> beg, iterator<T, Rank> end, Args...args)
+	{
+		return get_access<ExecutionPolicy, Mode, Type>(cgh, beg, detail::distance(beg, end), args...);
+	}
+
+	// Plain buffer accessors for kernels that index the buffer themselves. They are recorded with
+	// the profiler like the accessor proxies: the range and offset variant records its range, range
+	// mapper variants record the extent the whole kernel requests.
+
+	template<celerity::access_mode Mode, typename T, size_t Rank>
+	auto get_raw_access(celerity::handler cgh, const celerity::buffer<T, Rank>& buf, cl::sycl::range<Rank> r, cl::sycl::id<Rank> offset = {})
+	{
+		task_profile::record_access<Mode, T>(r);
+
+		return buf.template get_access<Mode>(cgh, r, offset);
+	}
+
+	template<celerity::access_mode Mode, typename T, size_t Rank, typename RangeMapper,
+		typename = std::enable_if_t<std::is_invocable_v<RangeMapper, celerity::chunk<Rank>>>>
+	auto get_raw_access(celerity::handler cgh, const celerity::buffer<T, Rank>& buf, RangeMapper rm, cl::sycl::range<Rank> r)
+	{
+		task_profile::record_access<Mode, T>(r);
 
-		return accessor_proxy<T, Rank, decltype(acc), Type>{ acc };
+		return buf.template get_access<Mode>(cgh, rm);
 	}
 }
 
@@ -11,13 +11,20 @@ namespace celerity::algorithm::actions
 	// unused
 	inline void global_barrier()
 	{
+#ifdef MOCK_CELERITY_MPI
+		celerity::detail::mpi_world::instance();
+#endif
 		MPI_Barrier(MPI_COMM_WORLD);
 	}
 
 	template<typename F, typename...Args>
 	auto on_master(F&& f, Args&& ...args)
 	{
-#ifdef MOCK_CELERITY
+#if defined(MOCK_CELERITY_MPI)
+		if (celerity::detail::mpi_world::instance().rank() != 0) return;
+
+		std::invoke(f, std::forward<Args>(args)...);
+#elif defined(MOCK_CELERITY)
 		std::invoke(f, std::forward<Args>(args)...);
 #else
 
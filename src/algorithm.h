@@ -6,32 +6,70 @@
 #include "task_sequence.h"
 #include "accessor_proxy.h"
 #include "policy.h"
+#include "scratch.h"
 #include <future>
+#include <optional>
+#include <tuple>
+#include <utility>
 
 namespace celerity::algorithm
 {
+	namespace detail
+	{
+		template<typename T>
+		struct is_iterator : std::false_type {};
+
+		template<typename T, size_t Rank>
+		struct is_iterator<iterator<T, Rank>> : std::true_type {};
+
+		template<typename T>
+		inline constexpr bool is_iterator_v = is_iterator<T>::value;
+
+		template<typename V>
+		struct convert_to
+		{
+			template<typename T>
+			V operator()(const T& x) const { return V(x); }
+		};
+	}
+
+	// one reduction of reduce_many: init combined with map(x) of every element
+	template<typename V, typename Combine, typename Map>
+	struct reducer
+	{
+		V init;
+		Combine combine;
+		Map map;
+	};
+
+	template<typename V, typename Combine, typename Map = detail::convert_to<V>>
+	reducer<V, Combine, Map> reduction(V init, Combine combine, Map map = {})
+	{
+		return { std::move(init), std::move(combine), std::move(map) };
+	}
+
 	namespace actions
 	{
 		namespace detail
 		{
-			template<access_type InputAccessorType, access_type OutputAccessorType, typename ExecutionPolicy, typename F, typename T,  size_t Rank>
-			auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> out, const F& f)
+			template<access_type InputAccessorType, access_type OutputAccessorType, typename ExecutionPolicy, typename F, typename T,  size_t Rank, typename...InputAccessorArgs>
+			auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> out, const F& f, InputAccessorArgs...input_args)
 			{
 				using execution_policy = std::decay_t<ExecutionPolicy>;
 
-				static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
-
-				const auto r = *end - *beg;
-				assert(r <= static_cast<int>(out.buffer().size() - *out));
+				const auto r = algorithm::detail::distance(beg, end);
+				assert(algorithm::detail::fits(out, r));
 
 				return [=](celerity::handler cgh)
 				{
-					const auto in_acc = get_access< celerity::access_mode::read, InputAccessorType>(cgh, beg, end);
-					auto out_acc = get_access<celerity::access_mode::write, OutputAccessorType>(cgh, out, out);
+					const auto in_acc = get_access<execution_policy, celerity::access_mode::read, InputAccessorType>(cgh, beg, end, input_args...);
+
+					// every element of the output range is written, so its previous contents need not be transferred
+					auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, OutputAccessorType>(cgh, out, r);
 
 					if constexpr (policy_traits<execution_policy>::is_distributed)
 					{
-						cgh.parallel_for<policy_traits<execution_policy>::kernel_name>(cl::sycl::range<Rank>{r}, [&](auto item)
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(r, [&](auto item)
 							{
 								out_acc[item] = f(in_acc[item]);
 							});
@@ -40,10 +78,8 @@ namespace celerity::algorithm
 					{
 						cgh.run([&]()
 							{
-								std::for_each(beg, end,
-									[&](auto i)
+								algorithm::detail::for_each_item(r, [&](auto item)
 									{
-										const cl::sycl::item<Rank> item{i};
 										out_acc[item] = f(in_acc[item]);
 									});
 							});
@@ -51,40 +87,72 @@ namespace celerity::algorithm
 				};
 			}
 
-			template<access_type FirstInputAccessorType, access_type SecondInputAccessorType, access_type OutputAccessorType, typename ExecutionPolicy, typename F, typename T, size_t Rank>
-			auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> beg2, iterator<T, Rank> out, const F& f)
+			// reads one element of every input per item, all inputs in the same kernel
+			template<typename ExecutionPolicy, typename F, typename U, size_t Rank, typename...Ts>
+			auto zip_transform(ExecutionPolicy p, iterator<U, Rank> out, cl::sycl::range<Rank> r, const F& f, iterator<Ts, Rank>...ins)
 			{
 				using execution_policy = std::decay_t<ExecutionPolicy>;
 
-				static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
-
-				const auto r = *end - *beg;
-				assert(r <= static_cast<int>(beg2.buffer().size() - *beg2));
-				assert(r <= static_cast<int>(out.buffer().size() - *out));
+				assert(algorithm::detail::fits(out, r));
+				assert((algorithm::detail::fits(ins, r) && ...));
 
 				return [=](celerity::handler cgh)
 				{
-					const auto first_in_acc = get_access< celerity::access_mode::read, FirstInputAccessorType>(cgh, beg, end);
-					const auto second_in_acc = get_access< celerity::access_mode::read, SecondInputAccessorType>(cgh, beg2, beg2);
+					const auto in_accs = std::make_tuple(get_access<execution_policy, celerity::access_mode::read, access_type::one_to_one>(cgh, ins, r)...);
+
+					auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, access_type::one_to_one>(cgh, out, r);
+
+					const auto apply = [&](auto item)
+					{
+						out_acc[item] = std::apply([&](const auto&...in_acc) { return f(in_acc[item]...); }, in_accs);
+					};
+
+					if constexpr (policy_traits<execution_policy>::is_distributed)
+					{
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(r, [&](auto item)
+							{
+								apply(item);
+							});
+					}
+					else
+					{
+						cgh.run([&]()
+							{
+								algorithm::detail::for_each_item(r, apply);
+							});
+					}
+				};
+			}
+
+			// invokes f once per chunk and stores the result at the position of the chunk in the chunk grid
+			template<typename ExecutionPolicy, typename F, typename T, size_t Rank>
+			auto transform_chunks(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> out, const F& f, cl::sycl::range<Rank> chunk_size)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
 
-					auto out_acc = get_access<celerity::access_mode::write, OutputAccessorType>(cgh, out, out);
+				const auto r = algorithm::detail::distance(beg, end);
+				const auto chunks = algorithm::detail::chunk_count(r, chunk_size);
+				assert(algorithm::detail::fits(out, chunks));
+
+				return [=](celerity::handler cgh)
+				{
+					const auto in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::chunk>(cgh, beg, end, chunk_size);
+					auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, access_type::one_to_one>(cgh, out, chunks);
 
 					if constexpr (policy_traits<execution_policy>::is_distributed)
 					{
-						cgh.parallel_for<policy_traits<execution_policy>::kernel_name>(cl::sycl::range<Rank>{r}, [&](auto item)
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(chunks, [&](auto item)
 							{
-								out_acc[item] = f(first_in_acc[item], second_in_acc[item]);
+								out_acc[item] = f(in_acc[item]);
 							});
 					}
 					else
 					{
 						cgh.run([&]()
 							{
-								std::for_each(beg, end,
-									[&](auto i)
+								algorithm::detail::for_each_item(chunks, [&](auto item)
 									{
-										const cl::sycl::item<Rank> item{ i };
-										out_acc[item] = f(first_in_acc[item], second_in_acc[item]);
+										out_acc[item] = f(in_acc[item]);
 									});
 							});
 					}
@@ -92,61 +160,129 @@ namespace celerity::algorithm
 			}
 
 			template<typename ExecutionPolicy, typename F, typename T, size_t Rank>
-			auto fill(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f)
+			auto for_each(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f)
 			{
 				using execution_policy = std::decay_t<ExecutionPolicy>;
 
-				static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+				const auto r = algorithm::detail::distance(beg, end);
 
-				const auto r = *end - *beg;
+				return [=](celerity::handler cgh)
+				{
+					auto acc = get_access<execution_policy, celerity::access_mode::read_write, access_type::one_to_one>(cgh, beg, end);
+
+					if constexpr (policy_traits<execution_policy>::is_distributed)
+					{
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(r, [&](auto item)
+							{
+								f(acc[item]);
+							});
+					}
+					else
+					{
+						cgh.run([&]()
+							{
+								algorithm::detail::for_each_item(r, [&](auto item)
+									{
+										f(acc[item]);
+									});
+							});
+					}
+				};
+			}
+
+			// invokes f once per chunk with read-write access to the elements of the chunk
+			template<typename ExecutionPolicy, typename F, typename T, size_t Rank>
+			auto for_each_chunk(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f, cl::sycl::range<Rank> chunk_size)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				const auto r = algorithm::detail::distance(beg, end);
+				const auto chunks = algorithm::detail::chunk_count(r, chunk_size);
 
 				return [=](celerity::handler cgh)
 				{
-					auto out_acc = get_access<celerity::access_mode::write, celerity::algorithm::access_type::one_to_one>(cgh, beg, end);
-	
+					auto acc = get_access<execution_policy, celerity::access_mode::read_write, access_type::chunk>(cgh, beg, end, chunk_size);
+
 					if constexpr (policy_traits<execution_policy>::is_distributed)
 					{
-						cgh.parallel_for<policy_traits<execution_policy>::kernel_name>(cl::sycl::range<Rank>{r}, [&](auto item)
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(chunks, [&](auto item)
 							{
-								out_acc[item] = f();
+								f(acc[item]);
 							});
 					}
 					else
 					{
 						cgh.run([&]()
 							{
-								std::for_each(beg, end,
-									[&](auto i)
+								algorithm::detail::for_each_item(chunks, [&](auto item)
 									{
-										const cl::sycl::item<Rank> item{ i };
-										out_acc[item] = f();
+										f(acc[item]);
 									});
 							});
 					}
 				};
 			}
+
+			template<typename ExecutionPolicy, typename F, typename T, size_t Rank>
+			auto generate(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				static_assert(std::is_invocable_v<F> || std::is_invocable_v<F, cl::sycl::item<Rank>>, "generator has to take no arguments or an item");
+
+				const auto r = algorithm::detail::distance(beg, end);
+
+				return [=](celerity::handler cgh)
+				{
+					auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, celerity::algorithm::access_type::one_to_one>(cgh, beg, end);
+
+					const auto generate_item = [&](const cl::sycl::item<Rank> item)
+					{
+						if constexpr (std::is_invocable_v<F, cl::sycl::item<Rank>>)
+						{
+							out_acc[item] = f(item);
+						}
+						else
+						{
+							out_acc[item] = f();
+						}
+					};
+	
+					if constexpr (policy_traits<execution_policy>::is_distributed)
+					{
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(r, [&](auto item)
+							{
+								generate_item(item);
+							});
+					}
+					else
+					{
+						cgh.run([&]()
+							{
+								algorithm::detail::for_each_item(r, generate_item);
+							});
+					}
+				};
+			}
 		
 			template<typename ExecutionPolicy, typename BinaryOp, typename T, size_t Rank,
 				typename = ::std::enable_if_t<algorithm::detail::get_accessor_type<BinaryOp, 1>() == access_type::one_to_one>>
 			auto accumulate(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, T init, const BinaryOp& op)
 			{
 				static_assert(!policy_traits<ExecutionPolicy>::is_distributed, "can not be distributed");
-				static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
 
-				const auto r = *end - *beg;
+				const auto r = algorithm::detail::distance(beg, end);
 
 				return [=](celerity::handler cgh)
 				{
-					const auto in_acc = get_access<access_mode::read, access_type::one_to_one>(cgh, beg, end);
+					const auto in_acc = get_access<ExecutionPolicy, access_mode::read, access_type::one_to_one>(cgh, beg, end);
 
 					auto sum = init;
 
 					cgh.run([&]()
 					{
-						std::for_each(beg, end,
-							[&](auto i)
+						algorithm::detail::for_each_item(r, [&](auto item)
 							{
-								const cl::sycl::item<Rank> item{ i };
 								sum = op(std::move(sum), in_acc[item]);
 							});
 					});
@@ -154,27 +290,292 @@ namespace celerity::algorithm
 					return sum;
 				};
 			}
+
+			// folds op2 over the element pairs of two equally shaped chunks without requiring an identity for op1
+			template<typename V, typename T, typename U, size_t Rank, typename BinaryOp1, typename BinaryOp2>
+			V chunk_inner_product(const chunk<T, Rank>& a, const chunk<U, Rank>& b, const BinaryOp1& op1, const BinaryOp2& op2)
+			{
+				if (a.contiguous() && b.contiguous())
+				{
+					auto first = a.begin();
+					auto first2 = b.begin();
+
+					V sum = op2(*first++, *first2++);
+					for (; first != a.end(); ++first, ++first2)
+					{
+						sum = op1(std::move(sum), op2(*first, *first2));
+					}
+					return sum;
+				}
+
+				std::optional<V> sum;
+				algorithm::detail::for_each_item(a.range(), [&](auto item)
+					{
+						const cl::sycl::id<Rank> pos = item;
+						sum = sum ? op1(std::move(*sum), op2(a[pos], b[pos])) : V(op2(a[pos], b[pos]));
+					});
+				return *sum;
+			}
+
+			// folds the mapped elements of a chunk without requiring an identity for reduce
+			template<typename V, typename T, size_t Rank, typename ReduceOp, typename TransformOp>
+			V chunk_transform_reduce(const chunk<T, Rank>& a, const ReduceOp& reduce, const TransformOp& transform)
+			{
+				if (a.contiguous())
+				{
+					auto first = a.begin();
+
+					V sum = transform(*first++);
+					for (; first != a.end(); ++first)
+					{
+						sum = reduce(std::move(sum), transform(*first));
+					}
+					return sum;
+				}
+
+				std::optional<V> sum;
+				algorithm::detail::for_each_item(a.range(), [&](auto item)
+					{
+						const cl::sycl::id<Rank> pos = item;
+						sum = sum ? reduce(std::move(*sum), transform(a[pos])) : V(transform(a[pos]));
+					});
+				return *sum;
+			}
+
+			// distributed: one partial result per chunk, folded on the master node; the mapped range is never stored
+			// master: a single pass
+			template<typename ExecutionPolicy, typename T, size_t Rank, typename V, typename ReduceOp, typename TransformOp>
+			auto transform_reduce(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, V init,
+				const ReduceOp& reduce, const TransformOp& transform, cl::sycl::range<Rank> chunk_size)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				const auto r = algorithm::detail::distance(beg, end);
+
+				if constexpr (policy_traits<execution_policy>::is_distributed)
+				{
+					const auto chunks = algorithm::detail::chunk_count(r, chunk_size);
+					const auto partials_scratch = algorithm::detail::scratch<V>(chunks);
+					const auto partials_beg = celerity::begin(*partials_scratch), partials_end = celerity::end(*partials_scratch);
+
+					const auto partial_kernel = [=, lease = partials_scratch](celerity::handler cgh)
+					{
+						const auto in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::chunk>(cgh, beg, end, chunk_size);
+						auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, access_type::one_to_one>(cgh, partials_beg, chunks);
+
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(chunks, [&](auto item)
+							{
+								out_acc[item] = chunk_transform_reduce<V>(in_acc[item], reduce, transform);
+							});
+					};
+
+					const auto fold_kernel = detail::accumulate(master(p.q), partials_beg, partials_end, init, reduce);
+
+					auto partial_task = task(p, partial_kernel);
+					auto fold_task = task<non_blocking_master_execution_policy>(fold_kernel);
+
+					return sequence<decltype(partial_task), decltype(fold_task)>{ partial_task, fold_task };
+				}
+				else
+				{
+					return task(p, [=](celerity::handler cgh)
+					{
+						const auto in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::one_to_one>(cgh, beg, end);
+
+						auto sum = init;
+
+						cgh.run([&]()
+						{
+							algorithm::detail::for_each_item(r, [&](auto item)
+								{
+									sum = reduce(std::move(sum), transform(in_acc[item]));
+								});
+						});
+
+						return sum;
+					});
+				}
+			}
+
+			// distributed: one partial result per chunk, folded on the master node
+			// master: a single pass over both ranges
+			template<typename ExecutionPolicy, typename T, typename U, size_t Rank, typename V, typename BinaryOp1, typename BinaryOp2>
+			auto inner_product(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<U, Rank> beg2, V init,
+				const BinaryOp1& op1, const BinaryOp2& op2, cl::sycl::range<Rank> chunk_size)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				const auto r = algorithm::detail::distance(beg, end);
+				assert(algorithm::detail::fits(beg2, r));
+
+				if constexpr (policy_traits<execution_policy>::is_distributed)
+				{
+					const auto chunks = algorithm::detail::chunk_count(r, chunk_size);
+					const auto partials_scratch = algorithm::detail::scratch<V>(chunks);
+					const auto partials_beg = celerity::begin(*partials_scratch), partials_end = celerity::end(*partials_scratch);
+
+					// The partial kernel holds the lease, so the partials return to the pool once its command
+					// group is released. Later users of the buffer are ordered after the fold by their accesses.
+					const auto partial_kernel = [=, lease = partials_scratch](celerity::handler cgh)
+					{
+						const auto first_in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::chunk>(cgh, beg, end, chunk_size);
+						const auto second_in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::chunk>(cgh, beg2, r, chunk_size);
+						auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, access_type::one_to_one>(cgh, partials_beg, chunks);
+
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(chunks, [&](auto item)
+							{
+								out_acc[item] = chunk_inner_product<V>(first_in_acc[item], second_in_acc[item], op1, op2);
+							});
+					};
+
+					const auto fold_kernel = detail::accumulate(master(p.q), partials_beg, partials_end, init, op1);
+
+					auto partial_task = task(p, partial_kernel);
+					auto fold_task = task<non_blocking_master_execution_policy>(fold_kernel);
+
+					return sequence<decltype(partial_task), decltype(fold_task)>{ partial_task, fold_task };
+				}
+				else
+				{
+					return task(p, [=](celerity::handler cgh)
+					{
+						const auto first_in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::one_to_one>(cgh, beg, end);
+						const auto second_in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::one_to_one>(cgh, beg2, r);
+
+						auto sum = init;
+
+						cgh.run([&]()
+						{
+							algorithm::detail::for_each_item(r, [&](auto item)
+								{
+									sum = op1(std::move(sum), op2(first_in_acc[item], second_in_acc[item]));
+								});
+						});
+
+						return sum;
+					});
+				}
+			}
+
+			// folds all reducers over a chunk, starting from the first element so that no identity is required
+			template<typename T, size_t Rank, typename...Reducers>
+			auto chunk_reduce(const chunk<T, Rank>& c, const std::tuple<Reducers...>& reducers)
+			{
+				std::optional<std::tuple<decltype(Reducers::init)...>> partial;
+
+				const auto fold = [&](const T& x)
+				{
+					partial = std::apply([&](const auto&...rs)
+						{
+							if (!partial) return std::make_tuple(rs.map(x)...);
+
+							return std::apply([&](auto...acc) { return std::make_tuple(rs.combine(std::move(acc), rs.map(x))...); }, std::move(*partial));
+						}, reducers);
+				};
+
+				if (c.contiguous())
+				{
+					std::for_each(c.begin(), c.end(), fold);
+				}
+				else
+				{
+					algorithm::detail::for_each_item(c.range(), [&](auto item) { fold(c[cl::sycl::id<Rank>(item)]); });
+				}
+
+				return *partial;
+			}
+
+			// distributed: one tuple of partial results per chunk, folded on the master node
+			// master: a single pass
+			template<typename ExecutionPolicy, typename T, size_t Rank, typename...Reducers>
+			auto reduce_many(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, cl::sycl::range<Rank> chunk_size, std::tuple<Reducers...> reducers)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+				using result_type = std::tuple<decltype(Reducers::init)...>;
+
+				const auto r = algorithm::detail::distance(beg, end);
+				const auto init = std::apply([](const auto&...rs) { return result_type{ rs.init... }; }, reducers);
+
+				if constexpr (policy_traits<execution_policy>::is_distributed)
+				{
+					const auto chunks = algorithm::detail::chunk_count(r, chunk_size);
+					const auto partials_scratch = algorithm::detail::scratch<result_type>(chunks);
+					const auto partials_beg = celerity::begin(*partials_scratch), partials_end = celerity::end(*partials_scratch);
+
+					const auto partial_kernel = [=, lease = partials_scratch](celerity::handler cgh)
+					{
+						const auto in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::chunk>(cgh, beg, end, chunk_size);
+						auto out_acc = get_access<execution_policy, celerity::access_mode::discard_write, access_type::one_to_one>(cgh, partials_beg, chunks);
+
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(chunks, [&](auto item)
+							{
+								out_acc[item] = chunk_reduce(in_acc[item], reducers);
+							});
+					};
+
+					const auto combine = [reducers](const result_type& a, const result_type& b)
+					{
+						return std::apply([&](const auto&...rs)
+							{
+								return std::apply([&](const auto&...x)
+									{
+										return std::apply([&](const auto&...y) { return result_type{ rs.combine(x, y)... }; }, b);
+									}, a);
+							}, reducers);
+					};
+
+					const auto fold_kernel = detail::accumulate(master(p.q), partials_beg, partials_end, init, combine);
+
+					auto partial_task = task(p, partial_kernel);
+					auto fold_task = task<non_blocking_master_execution_policy>(fold_kernel);
+
+					return sequence<decltype(partial_task), decltype(fold_task)>{ partial_task, fold_task };
+				}
+				else
+				{
+					return task(p, [=](celerity::handler cgh)
+					{
+						const auto in_acc = get_access<execution_policy, celerity::access_mode::read, access_type::one_to_one>(cgh, beg, end);
+
+						auto result = init;
+
+						cgh.run([&]()
+						{
+							algorithm::detail::for_each_item(r, [&](auto item)
+								{
+									const T x = in_acc[item];
+									result = std::apply([&](const auto&...rs)
+										{
+											return std::apply([&](auto...acc) { return result_type{ rs.combine(std::move(acc), rs.map(x))... }; }, std::move(result));
+										}, reducers);
+								});
+						});
+
+						return result;
+					});
+				}
+			}
 		}
 
 		template<typename ExecutionPolicy, typename T, size_t Rank, typename F, 
 			typename = std::enable_if_t<algorithm::detail::get_accessor_type<F, 0>() == access_type::slice>>
 		auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> out, const F & f, size_t slice_dim)
 		{
-			return task<ExecutionPolicy>(detail::transform<access_type::slice, access_type::one_to_one>(p, beg, end, out, f));
+			return task(p, detail::transform<access_type::slice, access_type::one_to_one>(p, beg, end, out, f, slice_dim));
 		}
 
 		template<typename ExecutionPolicy, typename T, size_t Rank, typename F, 
 			typename = std::enable_if_t<algorithm::detail::get_accessor_type<F, 0>() == access_type::one_to_one>>
 		auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> out, const F & f)
 		{
-			return task<ExecutionPolicy>(detail::transform<access_type::one_to_one, access_type::one_to_one>(p, beg, end, out, f));
+			return task(p, detail::transform<access_type::one_to_one, access_type::one_to_one>(p, beg, end, out, f));
 		}
 
 		template<typename ExecutionPolicy, typename T, size_t Rank, typename F,
 			typename = std::enable_if_t<algorithm::detail::get_accessor_type<F, 0>() == access_type::chunk>>
 		auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> out, const F & f, cl::sycl::range<Rank> chunk_size)
 		{
-			return task<ExecutionPolicy>(detail::transform<access_type::chunk, access_type::one_to_one>(p, beg, end, out, f));
+			return task(p, detail::transform_chunks(p, beg, end, out, f, chunk_size));
 		}
 
 		template<typename ExecutionPolicy, typename T, size_t Rank, typename F,
@@ -182,19 +583,97 @@ namespace celerity::algorithm
 										algorithm::detail::get_accessor_type<F, 1>() == access_type::one_to_one>>
 		auto transform(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<T, Rank> beg2, iterator<T, Rank> out, const F& f)
 		{
-			return task<ExecutionPolicy>(detail::transform<access_type::one_to_one, access_type::one_to_one, access_type::one_to_one>(p, beg, end, beg2, out, f));
+			return task(p, detail::zip_transform(p, out, algorithm::detail::distance(beg, end), f, beg, beg2));
+		}
+
+		// writes f(in1[i], ..., inN[i]) to every position i of [out_beg, out_end)
+		template<typename ExecutionPolicy, typename U, size_t Rank, typename F, typename...Ts,
+			typename = std::enable_if_t<algorithm::detail::takes_elements<F>(std::index_sequence_for<Ts...>{})>>
+		auto transform(ExecutionPolicy p, iterator<U, Rank> out_beg, iterator<U, Rank> out_end, const F& f, iterator<Ts, Rank>...ins)
+		{
+			return task(p, detail::zip_transform(p, out_beg, algorithm::detail::distance(out_beg, out_end), f, ins...));
 		}
 	
+		template<typename ExecutionPolicy, typename T, size_t Rank, typename F,
+			typename = std::enable_if_t<algorithm::detail::get_accessor_type<F, 0>() == access_type::one_to_one>>
+		auto for_each(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F & f)
+		{
+			return task(p, detail::for_each(p, beg, end, f));
+		}
+
+		template<typename ExecutionPolicy, typename T, size_t Rank, typename F,
+			typename = std::enable_if_t<algorithm::detail::get_accessor_type<F, 0>() == access_type::chunk>>
+		auto for_each(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F & f, cl::sycl::range<Rank> chunk_size)
+		{
+			return task(p, detail::for_each_chunk(p, beg, end, f, chunk_size));
+		}
+
 		template<typename ExecutionPolicy, typename T, size_t Rank, typename F>
 		auto fill(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F & f)
 		{
-			return task<ExecutionPolicy>(detail::fill(p, beg, end, f));
+			return task(p, detail::generate(p, beg, end, f));
+		}
+
+		template<typename ExecutionPolicy, typename T, size_t Rank>
+		auto fill(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const T & value)
+		{
+			return task(p, detail::generate(p, beg, end, [value]() { return value; }));
+		}
+
+		template<typename ExecutionPolicy, typename T, size_t Rank, typename F>
+		auto generate(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F & f)
+		{
+			return task(p, detail::generate(p, beg, end, f));
 		}
 	
 		template<typename ExecutionPolicy, typename BinaryOp, typename T, size_t Rank>
 		auto accumulate(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, T init, const BinaryOp & op)
 		{
-			return task<ExecutionPolicy>(detail::accumulate(p, beg, end, init, op));
+			return task(p, detail::accumulate(p, beg, end, init, op));
+		}
+
+		template<typename ExecutionPolicy, typename BinaryOp, typename T, size_t Rank>
+		auto reduce(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, T init, const BinaryOp & op)
+		{
+			return task(p, detail::accumulate(p, beg, end, init, op));
+		}
+
+		template<typename ExecutionPolicy, typename T, size_t Rank, typename V, typename ReduceOp, typename TransformOp,
+			typename = std::enable_if_t<!algorithm::detail::is_iterator_v<V>>>
+		auto transform_reduce(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, V init, const ReduceOp& reduce, const TransformOp& transform)
+		{
+			return detail::transform_reduce(p, beg, end, init, reduce, transform, algorithm::detail::default_chunk_size(algorithm::detail::distance(beg, end)));
+		}
+
+		// same as inner_product, with the argument order of std::transform_reduce
+		template<typename ExecutionPolicy, typename T, typename U, size_t Rank, typename V, typename ReduceOp = std::plus<V>, typename TransformOp = std::multiplies<V>>
+		auto transform_reduce(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<U, Rank> beg2, V init,
+			const ReduceOp& reduce = {}, const TransformOp& transform = {})
+		{
+			return detail::inner_product(p, beg, end, beg2, init, reduce, transform, algorithm::detail::default_chunk_size(algorithm::detail::distance(beg, end)));
+		}
+
+		// evaluates every reducer in one pass over the range, the result is a tuple with one value per reducer
+		template<typename ExecutionPolicy, typename T, size_t Rank, typename...Reducers>
+		auto reduce_many(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, Reducers...reducers)
+		{
+			static_assert(sizeof...(Reducers) > 0, "reduce_many requires at least one reducer");
+
+			return detail::reduce_many(p, beg, end, algorithm::detail::default_chunk_size(algorithm::detail::distance(beg, end)), std::make_tuple(std::move(reducers)...));
+		}
+
+		template<typename ExecutionPolicy, typename T, typename U, size_t Rank, typename V, typename BinaryOp1, typename BinaryOp2>
+		auto inner_product(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<U, Rank> beg2, V init,
+			const BinaryOp1& op1, const BinaryOp2& op2, cl::sycl::range<Rank> chunk_size)
+		{
+			return detail::inner_product(p, beg, end, beg2, init, op1, op2, chunk_size);
+		}
+
+		template<typename ExecutionPolicy, typename T, typename U, size_t Rank, typename V, typename BinaryOp1 = std::plus<V>, typename BinaryOp2 = std::multiplies<V>>
+		auto inner_product(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<U, Rank> beg2, V init,
+			const BinaryOp1& op1 = {}, const BinaryOp2& op2 = {})
+		{
+			return detail::inner_product(p, beg, end, beg2, init, op1, op2, algorithm::detail::default_chunk_size(algorithm::detail::distance(beg, end)));
 		}
 	}
 
@@ -213,17 +692,70 @@ namespace celerity::algorithm
 		actions::transform(p, beg, end, beg2, out, f, args...) | submit_to(p.q);
 	}
 
+	template<typename ExecutionPolicy, typename U, size_t Rank, typename F, typename...Ts,
+		typename = std::enable_if_t<detail::takes_elements<F>(std::index_sequence_for<Ts...>{})>>
+	void transform(ExecutionPolicy p, iterator<U, Rank> out_beg, iterator<U, Rank> out_end, const F& f, iterator<Ts, Rank>...ins)
+	{
+		actions::transform(p, out_beg, out_end, f, ins...) | submit_to(p.q);
+	}
+
+	template<typename ExecutionPolicy, typename T, size_t Rank, typename F, typename...Args,
+		typename = std::enable_if_t<detail::get_accessor_type<F, 0>() != access_type::invalid>>
+	void for_each(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f, Args...args)
+	{
+		actions::for_each(p, beg, end, f, args...) | submit_to(p.q);
+	}
+
 	template<typename ExecutionPolicy, typename T, size_t Rank, typename F>
 	void fill(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f)
 	{
 		actions::fill(p, beg, end, f) | submit_to(p.q);
 	}
 
+	template<typename ExecutionPolicy, typename T, size_t Rank>
+	void fill(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const T& value)
+	{
+		actions::fill(p, beg, end, value) | submit_to(p.q);
+	}
+
+	template<typename ExecutionPolicy, typename T, size_t Rank, typename F>
+	void generate(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const F& f)
+	{
+		actions::generate(p, beg, end, f) | submit_to(p.q);
+	}
+
 	template<typename ExecutionPolicy, typename BinaryOp, typename T, size_t Rank>
 	auto accumulate(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, T init, const BinaryOp& op)
 	{
 		return actions::accumulate(p, beg, end, init, op) | submit_to(p.q);
 	}
+
+	template<typename ExecutionPolicy, typename BinaryOp, typename T, size_t Rank>
+	auto reduce(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, T init, const BinaryOp& op)
+	{
+		return actions::reduce(p, beg, end, init, op) | submit_to(p.q);
+	}
+
+	// returns a future for distributed and non-blocking master policies
+	template<typename ExecutionPolicy, typename T, size_t Rank, typename...Args>
+	auto transform_reduce(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, Args...args)
+	{
+		return actions::transform_reduce(p, beg, end, args...) | submit_to(p.q);
+	}
+
+	// returns a future of the result tuple for distributed and non-blocking master policies
+	template<typename ExecutionPolicy, typename T, size_t Rank, typename...Reducers>
+	auto reduce_many(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, Reducers...reducers)
+	{
+		return actions::reduce_many(p, beg, end, reducers...) | submit_to(p.q);
+	}
+
+	// returns a future for distributed and non-blocking master policies
+	template<typename ExecutionPolicy, typename T, typename U, size_t Rank, typename V, typename...Args>
+	auto inner_product(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<U, Rank> beg2, V init, Args...args)
+	{
+		return actions::inner_product(p, beg, end, beg2, init, args...) | submit_to(p.q);
+	}
 }
 
 #endif
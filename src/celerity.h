@@ -9,12 +9,40 @@
 #include <iterator>
 #include <vector>
 #include <array>
+#include <cassert>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifdef MOCK_CELERITY_MPI
+#include <mpi.h>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#endif
 
 namespace cl::sycl
 {
 	template<size_t Rank>
 	using range = std::array<int, Rank>;
 
+	template<size_t Rank>
+	using id = std::array<int, Rank>;
+
 	template<size_t Rank>
 	using item = std::array<int, Rank>;
 
@@ -30,6 +58,33 @@ namespace celerity
 		{
 			return (std::get<Is>(r) * ... * 1);
 		}
+
+		template<size_t Rank>
+		int linearize(cl::sycl::id<Rank> idx, cl::sycl::range<Rank> r)
+		{
+			auto offset = 0;
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				offset = offset * r[i] + idx[i];
+			}
+			return offset;
+		}
+
+		template<size_t Dim, size_t Rank, typename F>
+		void dispatch_for(cl::sycl::range<Rank> r, cl::sycl::id<Rank> offset, cl::sycl::item<Rank>& item, const F& f)
+		{
+			for (item[Dim] = offset[Dim]; item[Dim] < offset[Dim] + r[Dim]; ++item[Dim])
+			{
+				if constexpr (Dim + 1 < Rank)
+				{
+					dispatch_for<Dim + 1>(r, offset, item, f);
+				}
+				else
+				{
+					f(item);
+				}
+			}
+		}
 	}
 
 	template<size_t Rank>
@@ -38,59 +93,85 @@ namespace celerity
 		return detail::dispatch_count(r, std::make_index_sequence<Rank>{});
 	}
 
-	struct handler
+	template<size_t Rank>
+	struct subrange
 	{
-		int invocations;
+		cl::sycl::id<Rank> offset;
+		cl::sycl::range<Rank> range;
+	};
 
-		template<typename KernelName, size_t Rank, typename F>
-		void parallel_for(cl::sycl::range<Rank> r, F f)
+	template<size_t Rank>
+	struct chunk
+	{
+		cl::sycl::id<Rank> offset;
+		cl::sycl::range<Rank> range;
+		cl::sycl::range<Rank> global_size;
+	};
+
+	namespace access
+	{
+		template<size_t Rank>
+		struct one_to_one
 		{
-			if constexpr (Rank == 1)
-			{
-				for (auto i = 0; i < count(r); ++i)
-				{
-					f(cl::sycl::item<Rank>{i});
-				}
-			}
-			else
+			subrange<Rank> operator()(chunk<Rank> chnk) const { return { chnk.offset, chnk.range }; }
+		};
+
+		template<size_t Rank>
+		struct slice
+		{
+			explicit slice(size_t dim) : dim(dim) {}
+
+			subrange<Rank> operator()(chunk<Rank> chnk) const
 			{
-				throw std::logic_error("not implemented");
+				subrange<Rank> sr{ chnk.offset, chnk.range };
+				sr.offset[dim] = 0;
+				sr.range[dim] = chnk.global_size[dim];
+				return sr;
 			}
-		}
 
-		template<typename F>
-		void run(F f)
-		{
-			f();
-		}
-	};
+			size_t dim;
+		};
 
-	class distr_queue
-	{
-	public:
-		template<typename F>
-		void submit(F f)
+		// the chunk extended by the given number of elements in every dimension, clamped to the global range
+		template<size_t Rank>
+		struct neighborhood
 		{
-			f(handler{ ++invocation_count_ });
-		}
+			template<typename...Extents, typename = std::enable_if_t<sizeof...(Extents) == Rank>>
+			explicit neighborhood(Extents...extents) : extent{ static_cast<int>(extents)... } {}
 
-		template<typename F>
-		void with_master_access(F f)
+			subrange<Rank> operator()(chunk<Rank> chnk) const
+			{
+				subrange<Rank> sr{ chnk.offset, chnk.range };
+
+				for (size_t i = 0; i < Rank; ++i)
+				{
+					sr.offset[i] = std::max(0, chnk.offset[i] - extent[i]);
+					sr.range[i] = std::min(chnk.global_size[i], chnk.offset[i] + chnk.range[i] + extent[i]) - sr.offset[i];
+				}
+
+				return sr;
+			}
+
+			std::array<int, Rank> extent;
+		};
+
+		template<size_t Rank>
+		struct fixed
 		{
-			f(handler{ ++invocation_count_ });
-		}
+			explicit fixed(subrange<Rank> sr) : sr(sr) {}
 
-		void wait();
+			subrange<Rank> operator()(chunk<Rank>) const { return sr; }
 
-	private:
-		int invocation_count_ = 0;
-	};
+			subrange<Rank> sr;
+		};
+	}
 
 	enum class access_mode
 	{
 		read,
 		write,
-		read_write
+		read_write,
+		discard_write
 	};
 
 	inline std::string to_string(const access_mode mode)
@@ -100,74 +181,1192 @@ namespace celerity
 		case access_mode::read: return "read";
 		case access_mode::write: return "write";
 		case access_mode::read_write: return "read_write";
+		case access_mode::discard_write: return "discard_write";
 		default: return "unknown";
 		}
 	}
 
-	template<typename T, size_t Rank>
-	class buffer;
+	namespace detail
+	{
+		// region of a buffer requested by a command group, padded to three dimensions
+		struct buffer_access
+		{
+			const void* buffer;
+			access_mode mode;
+			std::array<int, 3> offset;
+			std::array<int, 3> range;
+		};
 
-	template<access_mode Mode, typename T, size_t Rank>
-	class accessor
+		template<size_t Rank>
+		buffer_access make_buffer_access(const void* buffer, access_mode mode, const subrange<Rank>& sr)
+		{
+			buffer_access a{ buffer, mode, { 0, 0, 0 }, { 1, 1, 1 } };
+
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				a.offset[i] = sr.offset[i];
+				a.range[i] = sr.range[i];
+			}
+
+			return a;
+		}
+
+		// two accesses conflict if they overlap and at least one of them writes
+		inline bool conflict(const buffer_access& a, const buffer_access& b)
+		{
+			if (a.buffer != b.buffer) return false;
+			if (a.mode == access_mode::read && b.mode == access_mode::read) return false;
+
+			for (size_t i = 0; i < 3; ++i)
+			{
+				if (a.offset[i] + a.range[i] <= b.offset[i] || b.offset[i] + b.range[i] <= a.offset[i]) return false;
+			}
+
+			return true;
+		}
+
+		// Collects the accesses of a command group during the prepass.
+		// Range mappers are evaluated once the kernel range is known.
+		class access_recorder
+		{
+		public:
+			using deferred_access = std::function<buffer_access(const std::array<int, 3>* global_size)>;
+
+			void add(buffer_access a) { accesses_.push_back(a); }
+			void defer(deferred_access f) { deferred_.push_back(std::move(f)); }
+
+			template<size_t Rank>
+			void resolve(const cl::sycl::range<Rank>& global_size)
+			{
+				std::array<int, 3> padded{ 1, 1, 1 };
+				std::copy(global_size.begin(), global_size.end(), padded.begin());
+
+				resolve(&padded);
+			}
+
+			// accesses through range mappers without a kernel cover the whole buffer
+			std::vector<buffer_access> finish()
+			{
+				resolve(nullptr);
+				return std::move(accesses_);
+			}
+
+		private:
+			std::vector<buffer_access> accesses_;
+			std::vector<deferred_access> deferred_;
+
+			void resolve(const std::array<int, 3>* global_size)
+			{
+				for (const auto& f : deferred_)
+				{
+					accesses_.push_back(f(global_size));
+				}
+
+				deferred_.clear();
+			}
+		};
+	}
+
+	namespace detail
 	{
-	public:
-		explicit accessor(buffer<T, Rank>& buffer)
-			: buffer_(buffer) {}
+		// Optional control over how a kernel is split across ranks (MOCK_CELERITY_MPI only): relative weights
+		// per rank along the first dimension, a grid of ranks per dimension for block splits and a callback
+		// receiving the items and seconds of every rank.
+		struct split_hint
+		{
+			std::function<std::vector<double>(int ranks)> weights;
+			std::function<std::array<int, 3>(int ranks, const std::array<int, 3>& global_size)> grid;
+			std::function<void(const std::vector<int>& items, const std::vector<double>& seconds)> observe;
+		};
+	}
 
-		decltype(auto) operator[](cl::sycl::item<Rank> idx)
+#ifdef MOCK_CELERITY_MPI
+	// With MOCK_CELERITY_MPI every rank started by mpirun runs the program and keeps a full
+	// replica of each buffer. Kernels are split along their first dimension across ranks and
+	// each rank fetches the regions its chunk reads from the ranks holding the current values.
+	// Master access command groups run on every rank, so their results are available everywhere.
+	namespace detail
+	{
+		// MPI_COMM_WORLD, initialized on first use and finalized at exit unless the program did so itself
+		class mpi_world
+		{
+		public:
+			static const mpi_world& instance()
+			{
+				static mpi_world world;
+				return world;
+			}
+
+			mpi_world(const mpi_world&) = delete;
+			mpi_world& operator=(const mpi_world&) = delete;
+
+			~mpi_world()
+			{
+				if (int finalized = 0; owned_ && MPI_Finalized(&finalized) == MPI_SUCCESS && !finalized)
+				{
+					MPI_Finalize();
+				}
+			}
+
+			int rank() const { return rank_; }
+			int size() const { return size_; }
+
+		private:
+			int rank_ = 0;
+			int size_ = 1;
+			bool owned_ = false;
+
+			mpi_world()
+			{
+				if (int initialized = 0; MPI_Initialized(&initialized) == MPI_SUCCESS && !initialized)
+				{
+					MPI_Init(nullptr, nullptr);
+					owned_ = true;
+				}
+
+				MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+				MPI_Comm_size(MPI_COMM_WORLD, &size_);
+
+				if (size_ > 64)
+				{
+					throw std::runtime_error("mock runtime supports at most 64 ranks");
+				}
+			}
+		};
+
+		// bytes exchanged by this rank since startup
+		struct communication_stats
 		{
-			std::cout << typeid(T).name() << "& ";
-			print_accessor_type();
-			std::cout << "::operator [](";
-			std::copy(begin(idx), idx.end(), std::ostream_iterator<int>{ std::cout, "," });
-			std::cout << ")" << std::endl;
+			size_t bytes_sent = 0;
+			size_t bytes_received = 0;
+			size_t exchanges = 0;
+		};
 
-			static_assert(Rank == 1);
+		inline communication_stats& communication()
+		{
+			static communication_stats stats;
+			return stats;
+		}
 
-			return buffer_.data()[idx[0]];
+		// set of ranks, one bit per rank
+		using rank_mask = std::uint64_t;
+
+		inline rank_mask all_ranks()
+		{
+			const auto size = mpi_world::instance().size();
+			return size == 64 ? ~rank_mask{ 0 } : (rank_mask{ 1 } << size) - 1;
 		}
 
-		T operator[](cl::sycl::item<Rank> idx) const
+		// Buffer access of the live pass. Every element of a buffer records the ranks holding its
+		// current value; all ranks update this information identically, so it is never communicated.
+		struct distributed_access
 		{
-			std::cout << typeid(T).name() << "  ";
-			print_accessor_type();
-			std::cout << "::operator [](";
-			std::copy(idx.begin(), idx.end(), std::ostream_iterator<int>{ std::cout, "," });
-			std::cout << ")" << std::endl;
+			access_mode mode;
+			char* data;
+			size_t element_size;
+			std::vector<rank_mask>* valid;
+			std::array<int, 3> buffer_range;
+			// region requested for a chunk of the kernel, the whole request outside of kernels
+			std::function<buffer_access(const chunk<3>*)> region;
+		};
 
-			static_assert(Rank == 1);
+		template<typename F>
+		void for_each_element(const buffer_access& region, const std::array<int, 3>& buffer_range, const F& f)
+		{
+			for (auto i = region.offset[0]; i < region.offset[0] + region.range[0]; ++i)
+			{
+				for (auto j = region.offset[1]; j < region.offset[1] + region.range[1]; ++j)
+				{
+					const auto row = (i * buffer_range[1] + j) * buffer_range[2];
 
-			return buffer_.data()[idx[0]];
+					for (auto k = region.offset[2]; k < region.offset[2] + region.range[2]; ++k)
+					{
+						f(row + k);
+					}
+				}
+			}
 		}
 
-		static void print_accessor_type()
+		// makes regions[r] of the buffer current on rank r, copying each missing element from the lowest rank holding it
+		inline void fetch(const distributed_access& a, const std::vector<buffer_access>& regions)
 		{
-			std::cout << "accessor<" << to_string(Mode) << ", " << typeid(T).name() << ", " << Rank << ">";
+			const auto& world = mpi_world::instance();
+			const auto size = static_cast<size_t>(world.size());
+
+			std::vector<std::vector<char>> send(size);
+			std::vector<std::vector<int>> receive(size);
+
+			// sources are chosen among the ranks holding an element before this exchange
+			std::vector<std::pair<int, rank_mask>> received;
+
+			for (size_t r = 0; r < size; ++r)
+			{
+				const auto bit = rank_mask{ 1 } << r;
+
+				for_each_element(regions[r], a.buffer_range, [&](int e)
+					{
+						const auto valid = (*a.valid)[e];
+						if (valid & bit) return;
+
+						auto source = 0;
+						while (!(valid & (rank_mask{ 1 } << source))) ++source;
+
+						if (source == world.rank())
+						{
+							const auto element = a.data + e * a.element_size;
+							send[r].insert(send[r].end(), element, element + a.element_size);
+						}
+
+						if (static_cast<int>(r) == world.rank())
+						{
+							receive[source].push_back(e);
+						}
+
+						received.emplace_back(e, bit);
+					});
+			}
+
+			for (const auto& [e, bit] : received)
+			{
+				(*a.valid)[e] |= bit;
+			}
+
+			std::vector<int> send_counts(size), send_displs(size), receive_counts(size), receive_displs(size);
+			std::vector<char> send_data, receive_data;
+
+			for (size_t r = 0; r < size; ++r)
+			{
+				send_displs[r] = static_cast<int>(send_data.size());
+				send_counts[r] = static_cast<int>(send[r].size());
+				send_data.insert(send_data.end(), send[r].begin(), send[r].end());
+
+				receive_displs[r] = r == 0 ? 0 : receive_displs[r - 1] + receive_counts[r - 1];
+				receive_counts[r] = static_cast<int>(receive[r].size() * a.element_size);
+			}
+
+			receive_data.resize(receive_displs[size - 1] + receive_counts[size - 1]);
+
+			MPI_Alltoallv(send_data.data(), send_counts.data(), send_displs.data(), MPI_BYTE,
+				receive_data.data(), receive_counts.data(), receive_displs.data(), MPI_BYTE, MPI_COMM_WORLD);
+
+			for (size_t r = 0; r < size; ++r)
+			{
+				auto src = receive_data.data() + receive_displs[r];
+
+				for (const auto e : receive[r])
+				{
+					std::memcpy(a.data + e * a.element_size, src, a.element_size);
+					src += a.element_size;
+				}
+			}
+
+			auto& stats = communication();
+			stats.bytes_sent += send_data.size();
+			stats.bytes_received += receive_data.size();
+			++stats.exchanges;
 		}
 
-	private:
-		buffer<T, Rank>& buffer_;
-	};
+		// Ranks are arranged in a grid (row-major) and every dimension is split evenly between the
+		// ranks along it. Weights apply to the first dimension and are only used with a grid of slabs.
+		struct split_plan
+		{
+			std::vector<double> weights;
+			std::array<int, 3> grid;
+		};
 
-	template<typename T, size_t Rank>
-	class buffer
-	{
-	public:
-		explicit buffer(cl::sycl::range<Rank> size)
-			: buf_(count(size))
+		template<size_t Rank>
+		split_plan make_split_plan(const split_hint* hint, const cl::sycl::range<Rank>& global_size)
+		{
+			const auto size = mpi_world::instance().size();
+
+			split_plan plan{ {}, { size, 1, 1 } };
+
+			if (hint && hint->grid)
+			{
+				std::array<int, 3> padded{ 1, 1, 1 };
+				std::copy_n(global_size.begin(), Rank, padded.begin());
+
+				plan.grid = hint->grid(size, padded);
+				assert(plan.grid[0] * plan.grid[1] * plan.grid[2] == size);
+			}
+
+			if (hint && hint->weights && plan.grid[0] == size)
+			{
+				plan.weights = hint->weights(size);
+			}
+
+			return plan;
+		}
+
+		// first index of the part'th of parts pieces of extent, split evenly without weights
+		inline int split_point(int extent, int part, int parts, const std::vector<double>& weights)
 		{
+			if (weights.empty()) return extent * part / parts;
+			if (part == parts) return extent;
+
+			const auto total = std::accumulate(weights.begin(), weights.end(), 0.0);
+			const auto before = std::accumulate(weights.begin(), weights.begin() + part, 0.0);
+
+			return total > 0 ? static_cast<int>(extent * (before / total)) : extent * part / parts;
 		}
 
-		template<access_mode mode>
-		auto get_access(handler cgh, cl::sycl::range<Rank> range) { return accessor<mode, T, Rank>{*this}; }
+		// chunk of a kernel executed by a rank
+		template<size_t Rank>
+		chunk<Rank> rank_chunk(const cl::sycl::range<Rank>& global_size, int rank, const split_plan& plan)
+		{
+			const std::array<int, 3> coords{ rank / (plan.grid[1] * plan.grid[2]), rank / plan.grid[2] % plan.grid[1], rank % plan.grid[2] };
 
-		[[nodiscard]]
-		size_t size() const { return buf_.size(); }
+			static const std::vector<double> even;
 
-		auto& data() { return buf_; }
+			chunk<Rank> chnk{ {}, global_size, global_size };
 
-	private:
-		std::vector<T> buf_;
+			for (size_t d = 0; d < Rank; ++d)
+			{
+				const auto& weights = d == 0 ? plan.weights : even;
+
+				chnk.offset[d] = split_point(global_size[d], coords[d], plan.grid[d], weights);
+				chnk.range[d] = split_point(global_size[d], coords[d] + 1, plan.grid[d], weights) - chnk.offset[d];
+			}
+
+			return chnk;
+		}
+
+		template<size_t Rank>
+		std::vector<buffer_access> chunk_regions(const distributed_access& a, const cl::sycl::range<Rank>& global_size, const split_plan& plan)
+		{
+			const auto size = mpi_world::instance().size();
+
+			std::vector<buffer_access> regions;
+			regions.reserve(size);
+
+			for (auto r = 0; r < size; ++r)
+			{
+				const auto chnk = rank_chunk(global_size, r, plan);
+
+				chunk<3> padded{ { 0, 0, 0 }, { 1, 1, 1 }, { 1, 1, 1 } };
+				std::copy_n(chnk.offset.begin(), Rank, padded.offset.begin());
+				std::copy_n(chnk.range.begin(), Rank, padded.range.begin());
+				std::copy_n(chnk.global_size.begin(), Rank, padded.global_size.begin());
+
+				regions.push_back(a.region(&padded));
+			}
+
+			return regions;
+		}
+
+		// fetches the inputs of every rank's chunk and returns the chunk of this rank
+		template<size_t Rank>
+		chunk<Rank> distribute(const std::vector<distributed_access>& accesses, const cl::sycl::range<Rank>& global_size, const split_plan& plan)
+		{
+			for (const auto& a : accesses)
+			{
+				if (a.mode == access_mode::discard_write) continue;
+
+				fetch(a, chunk_regions(a, global_size, plan));
+			}
+
+			return rank_chunk(global_size, mpi_world::instance().rank(), plan);
+		}
+
+		// after a kernel, only the rank that wrote an element holds its current value
+		template<size_t Rank>
+		void commit(std::vector<distributed_access>& accesses, const cl::sycl::range<Rank>& global_size, const split_plan& plan)
+		{
+			for (const auto& a : accesses)
+			{
+				if (a.mode == access_mode::read) continue;
+
+				const auto regions = chunk_regions(a, global_size, plan);
+
+				for (size_t r = 0; r < regions.size(); ++r)
+				{
+					for_each_element(regions[r], a.buffer_range, [&](int e) { (*a.valid)[e] = rank_mask{ 1 } << r; });
+				}
+			}
+
+			accesses.clear();
+		}
+
+		// shares the execution time of this rank's chunk with all ranks and reports it to the hint
+		template<size_t Rank>
+		void observe(const split_hint& hint, const cl::sycl::range<Rank>& global_size, const split_plan& plan, double seconds)
+		{
+			const auto size = mpi_world::instance().size();
+
+			std::vector<double> times(size);
+			MPI_Allgather(&seconds, 1, MPI_DOUBLE, times.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+
+			std::vector<int> items(size);
+			for (auto r = 0; r < size; ++r)
+			{
+				items[r] = count(rank_chunk(global_size, r, plan).range);
+			}
+
+			hint.observe(items, times);
+		}
+
+		// host tasks read their whole request on every rank
+		inline void replicate(const std::vector<distributed_access>& accesses)
+		{
+			for (const auto& a : accesses)
+			{
+				if (a.mode == access_mode::discard_write) continue;
+
+				fetch(a, std::vector<buffer_access>(mpi_world::instance().size(), a.region(nullptr)));
+			}
+		}
+
+		inline void commit_replicated(std::vector<distributed_access>& accesses)
+		{
+			for (const auto& a : accesses)
+			{
+				if (a.mode == access_mode::read) continue;
+
+				for_each_element(a.region(nullptr), a.buffer_range, [&](int e) { (*a.valid)[e] = all_ranks(); });
+			}
+
+			accesses.clear();
+		}
+	}
+#endif
+
+	namespace detail
+	{
+		template<size_t Rank, typename F>
+		void parallel_dispatch(cl::sycl::range<Rank> r, const F& f);
+	}
+
+	// Command groups are invoked twice: a prepass on submission records the requested
+	// accesses (kernels are not run), the live pass later executes the kernels.
+	struct handler
+	{
+		int invocations = 0;
+		detail::access_recorder* recorder = nullptr;
+		std::shared_ptr<const detail::split_hint> split = nullptr;
+#ifdef MOCK_CELERITY_MPI
+		std::vector<detail::distributed_access>* accesses = nullptr;
+#endif
+
+		template<typename KernelName, size_t Rank, typename F>
+		void parallel_for(cl::sycl::range<Rank> r, F f)
+		{
+			if (recorder)
+			{
+				recorder->resolve(r);
+				return;
+			}
+
+#ifdef MOCK_CELERITY_MPI
+			if (accesses)
+			{
+				const auto plan = detail::make_split_plan(split.get(), r);
+				const auto own = detail::distribute(*accesses, r, plan);
+
+				const auto start = std::chrono::steady_clock::now();
+
+				cl::sycl::item<Rank> item{};
+				detail::dispatch_for<0>(own.range, own.offset, item, f);
+
+				const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+				detail::commit(*accesses, r, plan);
+
+				if (split && split->observe)
+				{
+					detail::observe(*split, r, plan, elapsed.count());
+				}
+
+				return;
+			}
+#endif
+
+			detail::parallel_dispatch(r, f);
+		}
+
+		template<typename F>
+		void run(F f)
+		{
+			if (recorder) return;
+
+#ifdef MOCK_CELERITY_MPI
+			if (accesses)
+			{
+				detail::replicate(*accesses);
+				f();
+				detail::commit_replicated(*accesses);
+				return;
+			}
+#endif
+
+			f();
+		}
+	};
+
+	namespace detail
+	{
+		// State of the command group executing on the calling thread that its kernels read, such as the
+		// parameter bindings of a replayed task graph. Workers running parts of a parallel_for see the
+		// context of the worker executing the command group.
+		inline const void*& kernel_context()
+		{
+			thread_local const void* c = nullptr;
+			return c;
+		}
+
+		// CPU time consumed by the calling thread
+		inline double thread_seconds()
+		{
+#ifdef _WIN32
+			return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+			timespec ts{};
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+			return static_cast<double>(ts.tv_sec) + ts.tv_nsec * 1e-9;
+#endif
+		}
+
+		// Executes command groups on worker threads in dependency order.
+		// The number of workers is taken from MOCK_CELERITY_WORKERS and defaults to the number
+		// of hardware threads; zero workers execute every command group on submission.
+		// MOCK_CELERITY_MPI always executes on submission.
+		// A parallel_for is split along its first dimension into one part per worker, idle
+		// workers help the worker executing the command group with its parts.
+		class runtime
+		{
+		public:
+			static runtime& instance()
+			{
+				static runtime rt;
+				return rt;
+			}
+
+			runtime(const runtime&) = delete;
+			runtime& operator=(const runtime&) = delete;
+
+			~runtime()
+			{
+				{
+					std::unique_lock<std::mutex> lock{ mutex_ };
+					idle_.wait(lock, [this]() { return pending_.empty(); });
+					shutdown_ = true;
+				}
+
+				ready_cv_.notify_all();
+
+				for (auto& w : workers_)
+				{
+					w.join();
+				}
+			}
+
+			void submit(std::function<void(handler)> cgf)
+			{
+				auto accesses = record(cgf);
+				submit(std::move(cgf), std::move(accesses));
+			}
+
+			// submits a command group whose accesses are already known, skipping the prepass
+			void submit(std::function<void(handler)> cgf, std::vector<buffer_access> accesses)
+			{
+				auto t = std::make_shared<task>();
+				t->invocation = ++invocations_;
+				t->accesses = std::move(accesses);
+				t->cgf = std::move(cgf);
+
+				{
+					std::lock_guard<std::mutex> lock{ mutex_ };
+
+					for (const auto& other : pending_)
+					{
+						if (depends_on(*t, *other))
+						{
+							other->successors.push_back(t);
+							++t->dependencies;
+						}
+					}
+
+					pending_.push_back(t);
+
+					if (t->dependencies == 0)
+					{
+						ready_.push_back(t);
+					}
+				}
+
+				if (workers_.empty())
+				{
+					drain();
+				}
+				else
+				{
+					ready_cv_.notify_one();
+				}
+			}
+
+			int workers() const { return static_cast<int>(workers_.size()); }
+
+			// Runs body(part) for every part in [0, parts) on the calling thread and idle workers.
+			// Returns once all parts are done and rethrows the first exception thrown by a part.
+			template<typename F>
+			void fork_join(int parts, const F& body)
+			{
+				fork f{ [](const void* b, int part) { (*static_cast<const F*>(b))(part); }, &body, kernel_context(), parts };
+
+				std::unique_lock<std::mutex> lock{ mutex_ };
+				forks_.push_back(&f);
+				ready_cv_.notify_all();
+
+				// the caller claims parts like any worker, so a busy runtime cannot stall the command group
+				while (f.claimed < f.parts)
+				{
+					run_part(f, lock);
+				}
+
+				joined_.wait(lock, [&]() { return f.done == f.parts; });
+
+				if (f.error)
+				{
+					std::rethrow_exception(f.error);
+				}
+			}
+
+			// mock extension: CPU time each worker spent executing command groups since the last call
+			std::vector<double> take_busy_seconds()
+			{
+				std::lock_guard<std::mutex> lock{ mutex_ };
+				auto busy = busy_;
+				std::fill(busy_.begin(), busy_.end(), 0.0);
+				return busy;
+			}
+
+			// accesses requested by a command group, obtained by a prepass
+			std::vector<buffer_access> record(const std::function<void(handler)>& cgf)
+			{
+				access_recorder recorder;
+				cgf(handler{ invocations_ + 1, &recorder });
+				return recorder.finish();
+			}
+
+			// blocks until every submitted command group has been executed
+			void wait()
+			{
+				std::unique_lock<std::mutex> lock{ mutex_ };
+				idle_.wait(lock, [this]() { return pending_.empty(); });
+
+				if (error_)
+				{
+					std::rethrow_exception(std::exchange(error_, nullptr));
+				}
+			}
+
+		private:
+			struct task
+			{
+				int invocation = 0;
+				std::function<void(handler)> cgf;
+				std::vector<buffer_access> accesses;
+				std::vector<std::shared_ptr<task>> successors;
+				int dependencies = 0;
+			};
+
+			// FIFO of tasks reusing its storage: a std::deque allocates whenever its end crosses
+			// into a new block, so steady submission would allocate every few tasks
+			class ready_queue
+			{
+			public:
+				bool empty() const { return head_ == tasks_.size(); }
+
+				void push_back(std::shared_ptr<task> t) { tasks_.push_back(std::move(t)); }
+
+				std::shared_ptr<task> pop_front()
+				{
+					auto t = std::move(tasks_[head_++]);
+
+					// compacting in place keeps the capacity
+					if (head_ * 2 >= tasks_.size())
+					{
+						tasks_.erase(tasks_.begin(), tasks_.begin() + head_);
+						head_ = 0;
+					}
+
+					return t;
+				}
+
+			private:
+				std::vector<std::shared_ptr<task>> tasks_;
+				size_t head_ = 0;
+			};
+
+			// parts of a parallel_for, the caller's stack owns it until every part is done
+			struct fork
+			{
+				void (*run)(const void* body, int part);
+				const void* body;
+				const void* context;
+				int parts;
+				int claimed = 0;
+				int done = 0;
+				std::exception_ptr error = nullptr;
+			};
+
+			std::mutex mutex_;
+			std::condition_variable ready_cv_;
+			std::condition_variable idle_;
+			std::condition_variable joined_;
+			ready_queue ready_;
+			std::vector<fork*> forks_;
+			std::vector<std::shared_ptr<task>> pending_;
+			std::vector<std::thread> workers_;
+			std::vector<double> busy_;
+			std::exception_ptr error_;
+			std::atomic<int> invocations_{ 0 };
+			bool shutdown_ = false;
+
+			runtime()
+			{
+				auto workers = static_cast<int>(std::thread::hardware_concurrency());
+
+				if (const auto env = std::getenv("MOCK_CELERITY_WORKERS"))
+				{
+					workers = std::atoi(env);
+				}
+
+#ifdef MOCK_CELERITY_MPI
+				// ranks have to execute command groups and their collective exchanges in submission order
+				mpi_world::instance();
+				workers = 0;
+#endif
+
+				busy_.resize(std::max(workers, 0));
+
+				for (auto i = 0; i < std::max(workers, 0); ++i)
+				{
+					workers_.emplace_back([this, i]() { work(i); });
+				}
+			}
+
+			static bool depends_on(const task& t, const task& other)
+			{
+				for (const auto& a : t.accesses)
+				{
+					for (const auto& b : other.accesses)
+					{
+						if (conflict(a, b)) return true;
+					}
+				}
+
+				return false;
+			}
+
+			void work(int index)
+			{
+				std::unique_lock<std::mutex> lock{ mutex_ };
+
+				for (;;)
+				{
+					ready_cv_.wait(lock, [this]() { return shutdown_ || !forks_.empty() || !ready_.empty(); });
+
+					// parts of a running command group come first, they are on its critical path
+					if (!forks_.empty())
+					{
+						const auto start = thread_seconds();
+						run_part(*forks_.back(), lock);
+						busy_[index] += thread_seconds() - start;
+					}
+					else if (!ready_.empty())
+					{
+						auto t = ready_.pop_front();
+
+						lock.unlock();
+						execute(t, &busy_[index]);
+						lock.lock();
+					}
+					else
+					{
+						return;
+					}
+				}
+			}
+
+			// claims the next part of f and runs it with the lock released
+			void run_part(fork& f, std::unique_lock<std::mutex>& lock)
+			{
+				const auto part = f.claimed++;
+
+				if (f.claimed == f.parts)
+				{
+					forks_.erase(std::find(forks_.begin(), forks_.end(), &f));
+				}
+
+				lock.unlock();
+
+				const auto context = std::exchange(kernel_context(), f.context);
+				std::exception_ptr error;
+
+				try
+				{
+					f.run(f.body, part);
+				}
+				catch (...)
+				{
+					error = std::current_exception();
+				}
+
+				kernel_context() = context;
+				lock.lock();
+
+				if (error && !f.error) f.error = error;
+
+				if (++f.done == f.parts)
+				{
+					joined_.notify_all();
+				}
+			}
+
+			void drain()
+			{
+				for (;;)
+				{
+					std::shared_ptr<task> t;
+
+					{
+						std::lock_guard<std::mutex> lock{ mutex_ };
+
+						if (ready_.empty()) return;
+
+						t = ready_.pop_front();
+					}
+
+					execute(t);
+				}
+			}
+
+			// busy, if given, is charged with the CPU time of the command group before it completes
+			void execute(const std::shared_ptr<task>& t, double* busy = nullptr)
+			{
+				const auto start = thread_seconds();
+
+				try
+				{
+#ifdef MOCK_CELERITY_MPI
+					std::vector<distributed_access> accesses;
+					t->cgf(handler{ t->invocation, nullptr, nullptr, &accesses });
+#else
+					t->cgf(handler{ t->invocation });
+#endif
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock{ mutex_ };
+					if (!error_) error_ = std::current_exception();
+				}
+
+				// release captured state before the task is reported as completed
+				t->cgf = nullptr;
+
+				auto ready = 0;
+
+				{
+					std::lock_guard<std::mutex> lock{ mutex_ };
+
+					if (busy) *busy += thread_seconds() - start;
+
+					for (const auto& s : t->successors)
+					{
+						if (--s->dependencies == 0)
+						{
+							ready_.push_back(s);
+							++ready;
+						}
+					}
+
+					pending_.erase(std::find(pending_.begin(), pending_.end(), t));
+
+					if (pending_.empty())
+					{
+						idle_.notify_all();
+					}
+				}
+
+				for (auto i = 0; i < ready; ++i)
+				{
+					ready_cv_.notify_one();
+				}
+			}
+		};
+	}
+
+	namespace detail
+	{
+		template<size_t Rank, typename F>
+		void parallel_dispatch(cl::sycl::range<Rank> r, const F& f)
+		{
+			auto& rt = runtime::instance();
+			const auto parts = std::min(rt.workers(), r[0]);
+
+			if (parts < 2)
+			{
+				cl::sycl::item<Rank> item{};
+				dispatch_for<0>(r, cl::sycl::id<Rank>{}, item, f);
+				return;
+			}
+
+			rt.fork_join(parts, [&](int part)
+				{
+					auto offset = cl::sycl::id<Rank>{};
+					auto range = r;
+					offset[0] = r[0] * part / parts;
+					range[0] = r[0] * (part + 1) / parts - offset[0];
+
+					cl::sycl::item<Rank> item{};
+					dispatch_for<0>(range, offset, item, f);
+				});
+		}
+	}
+
+	// Copies of a queue refer to the same runtime.
+	class distr_queue
+	{
+	public:
+		template<typename F>
+		void submit(F f)
+		{
+			detail::runtime::instance().submit(std::move(f));
+		}
+
+		// mock extension: submits a command group with accesses recorded before, see runtime::record
+		template<typename F>
+		void submit(F f, std::vector<detail::buffer_access> accesses)
+		{
+			detail::runtime::instance().submit(std::move(f), std::move(accesses));
+		}
+
+		// unlike the real runtime, the mock returns the result of the command group's live pass
+		template<typename F>
+		auto with_master_access(F f)
+		{
+			using result_type = std::invoke_result_t<F, handler>;
+
+			auto promise = std::make_shared<std::promise<result_type>>();
+			auto future = promise->get_future();
+
+			detail::runtime::instance().submit([f = std::move(f), promise](handler cgh)
+				{
+					if (cgh.recorder)
+					{
+						f(cgh);
+						return;
+					}
+
+					try
+					{
+						if constexpr (std::is_void_v<result_type>)
+						{
+							f(cgh);
+							promise->set_value();
+						}
+						else
+						{
+							promise->set_value(f(cgh));
+						}
+					}
+					catch (...)
+					{
+						promise->set_exception(std::current_exception());
+					}
+				});
+
+			return future;
+		}
+
+		void wait() { detail::runtime::instance().wait(); }
+	};
+
+	namespace detail
+	{
+		// Accessors print every element access. Defining MOCK_CELERITY_QUIET or setting it in the
+		// environment (to anything but 0) turns the tracing off, e.g. for benchmarks.
+		inline bool trace_accesses()
+		{
+#ifdef MOCK_CELERITY_QUIET
+			return false;
+#else
+			static const bool enabled = []()
+			{
+				const auto env = std::getenv("MOCK_CELERITY_QUIET");
+				return !env || std::string{ env } == "0";
+			}();
+
+			return enabled;
+#endif
+		}
+
+		// accesses of kernels running on different workers are written one whole line at a time
+		inline void trace_access(const std::string& line)
+		{
+			static std::mutex mutex;
+
+			std::lock_guard<std::mutex> lock{ mutex };
+			std::cout << line << std::endl;
+		}
+	}
+
+	template<typename T, size_t Rank>
+	class buffer;
+
+	template<access_mode Mode, typename T, size_t Rank>
+	class accessor
+	{
+	public:
+		explicit accessor(buffer<T, Rank> buffer)
+			: buffer_(std::move(buffer)) {}
+
+		decltype(auto) operator[](cl::sycl::item<Rank> idx)
+		{
+			if (detail::trace_accesses()) trace("& ", idx);
+
+			return buffer_.data()[detail::linearize(idx, buffer_.get_range())];
+		}
+
+		T operator[](cl::sycl::item<Rank> idx) const
+		{
+			if (detail::trace_accesses()) trace("  ", idx);
+
+			return buffer_.data()[detail::linearize(idx, buffer_.get_range())];
+		}
+
+		T* get_pointer() const { return buffer_.data().data(); }
+
+		static void print_accessor_type(std::ostream& os = std::cout)
+		{
+			os << "accessor<" << to_string(Mode) << ", " << typeid(T).name() << ", " << Rank << ">";
+		}
+
+	private:
+		buffer<T, Rank> buffer_;
+
+		static void trace(const char* ref, cl::sycl::item<Rank> idx)
+		{
+			std::ostringstream line;
+			line << typeid(T).name() << ref;
+			print_accessor_type(line);
+			line << "::operator [](";
+			std::copy(idx.begin(), idx.end(), std::ostream_iterator<int>{ line, "," });
+			line << ")";
+
+			detail::trace_access(line.str());
+		}
+	};
+
+	// Copies of a buffer refer to the same storage.
+	template<typename T, size_t Rank>
+	class buffer
+	{
+	public:
+		explicit buffer(cl::sycl::range<Rank> size)
+			: storage_(std::make_shared<storage>(storage{ size, std::vector<T>(count(size)) }))
+		{
+		}
+
+		// initialized with a copy of count(size) elements at host_ptr
+		buffer(const T* host_ptr, cl::sycl::range<Rank> size)
+			: storage_(std::make_shared<storage>(storage{ size, std::vector<T>(host_ptr, host_ptr + count(size)) }))
+		{
+		}
+
+		template<access_mode mode>
+		auto get_access(handler cgh, cl::sycl::range<Rank> range, cl::sycl::id<Rank> offset = {}) const
+		{
+			if (cgh.recorder)
+			{
+				cgh.recorder->add(detail::make_buffer_access(storage_.get(), mode, subrange<Rank>{ offset, range }));
+			}
+
+#ifdef MOCK_CELERITY_MPI
+			if (cgh.accesses)
+			{
+				cgh.accesses->push_back(distributed(mode, [sr = subrange<Rank>{ offset, range }](const chunk<Rank>*) { return sr; }));
+			}
+#endif
+
+			return accessor<mode, T, Rank>{ *this };
+		}
+
+		template<access_mode mode, typename RangeMapper,
+			typename = std::enable_if_t<std::is_invocable_v<RangeMapper, chunk<Rank>>>>
+		auto get_access(handler cgh, RangeMapper rm) const
+		{
+			if (cgh.recorder)
+			{
+				// the range is read through the storage, which keeps the capture within std::function's inline buffer
+				cgh.recorder->defer([id = storage_.get(), rm](const std::array<int, 3>* global_size)
+					{
+						chunk<Rank> chnk{ {}, id->range, id->range };
+
+						if (global_size)
+						{
+							std::copy_n(global_size->begin(), Rank, chnk.range.begin());
+							chnk.global_size = chnk.range;
+						}
+
+						return detail::make_buffer_access(id, mode, rm(chnk));
+					});
+			}
+
+#ifdef MOCK_CELERITY_MPI
+			if (cgh.accesses)
+			{
+				cgh.accesses->push_back(distributed(mode, [r = get_range(), rm](const chunk<Rank>* chnk)
+					{
+						return chnk ? rm(*chnk) : rm(chunk<Rank>{ {}, r, r });
+					}));
+			}
+#endif
+
+			return accessor<mode, T, Rank>{ *this };
+		}
+
+		[[nodiscard]]
+		size_t size() const { return storage_->data.size(); }
+
+		[[nodiscard]]
+		cl::sycl::range<Rank> get_range() const { return storage_->range; }
+
+		std::vector<T>& data() const { return storage_->data; }
+
+	private:
+		struct storage
+		{
+			cl::sycl::range<Rank> range;
+			std::vector<T> data;
+#ifdef MOCK_CELERITY_MPI
+			std::vector<detail::rank_mask> valid = std::vector<detail::rank_mask>(data.size(), detail::all_ranks());
+#endif
+		};
+
+#ifdef MOCK_CELERITY_MPI
+		template<typename Region>
+		detail::distributed_access distributed(access_mode mode, Region region) const
+		{
+			std::array<int, 3> buffer_range{ 1, 1, 1 };
+			std::copy_n(storage_->range.begin(), Rank, buffer_range.begin());
+
+			return { mode, reinterpret_cast<char*>(storage_->data.data()), sizeof(T), &storage_->valid, buffer_range,
+				[id = storage_.get(), mode, region](const chunk<3>* padded)
+				{
+					if (!padded) return detail::make_buffer_access(id, mode, region(nullptr));
+
+					chunk<Rank> chnk;
+					std::copy_n(padded->offset.begin(), Rank, chnk.offset.begin());
+					std::copy_n(padded->range.begin(), Rank, chnk.range.begin());
+					std::copy_n(padded->global_size.begin(), Rank, chnk.global_size.begin());
+
+					return detail::make_buffer_access(id, mode, region(&chnk));
+				} };
+		}
+#endif
+
+		std::shared_ptr<storage> storage_;
 	};
 }
 
@@ -0,0 +1,136 @@
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace celerity::algorithm
+{
+	// IEEE 754 binary16, rounding to nearest even
+	struct half_encoding
+	{
+		using value_type = float;
+		using storage_type = std::uint16_t;
+
+		static storage_type encode(float value)
+		{
+			std::uint32_t x;
+			std::memcpy(&x, &value, sizeof(x));
+
+			const auto sign = static_cast<storage_type>((x >> 16) & 0x8000);
+			const auto abs = x & 0x7fffffff;
+
+			// nan and inf, nan keeps a payload bit
+			if (abs >= 0x7f800000) return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+
+			// 65520 and above round to inf
+			if (abs >= 0x477ff000) return sign | 0x7c00;
+
+			// below the smallest normal half: subnormal or zero
+			if (abs < 0x38800000)
+			{
+				const auto shift = 126 - static_cast<int>(abs >> 23);
+				if (shift > 24) return sign;
+
+				const auto mantissa = (abs & 0x7fffff) | 0x800000;
+				return sign | round(mantissa, shift);
+			}
+
+			// rebias the exponent from 127 to 15
+			return sign | round(abs - 0x38000000, 13);
+		}
+
+		static float decode(storage_type bits)
+		{
+			const auto negative = (bits & 0x8000) != 0;
+			const std::uint32_t exponent = (bits >> 10) & 0x1f;
+			const std::uint32_t mantissa = bits & 0x3ff;
+
+			if (exponent == 0)
+			{
+				const auto value = std::ldexp(static_cast<float>(mantissa), -24);
+				return negative ? -value : value;
+			}
+
+			const std::uint32_t x = (negative ? 0x80000000u : 0u)
+				| (exponent == 0x1f ? 0x7f800000u : (exponent + 112) << 23)
+				| (mantissa << 13);
+
+			float value;
+			std::memcpy(&value, &x, sizeof(value));
+			return value;
+		}
+
+	private:
+		static storage_type round(std::uint32_t bits, int shift)
+		{
+			const auto halfway = 1u << (shift - 1);
+			const auto rest = bits & ((1u << shift) - 1);
+
+			auto result = bits >> shift;
+			if (rest > halfway || (rest == halfway && (result & 1))) ++result;
+
+			return static_cast<storage_type>(result);
+		}
+	};
+
+	// signed fixed point with FractionalBits bits after the binary point, saturating
+	template<int FractionalBits, typename Storage = std::int16_t>
+	struct fixed_point_encoding
+	{
+		static_assert(std::is_integral_v<Storage> && std::is_signed_v<Storage>, "fixed point storage has to be a signed integer");
+		static_assert(FractionalBits >= 0 && FractionalBits < std::numeric_limits<Storage>::digits, "too many fractional bits for the storage type");
+
+		using value_type = float;
+		using storage_type = Storage;
+
+		static storage_type encode(float value)
+		{
+			// max() is not representable in float for 32 and 64 bit storage, so the range is checked
+			// against the power of two above it, which is exact in double like every value below it
+			const auto limit = std::ldexp(1.0, std::numeric_limits<Storage>::digits);
+
+			if (std::isnan(value)) return 0;
+
+			const auto scaled = std::nearbyint(std::ldexp(static_cast<double>(value), FractionalBits));
+
+			if (scaled >= limit) return std::numeric_limits<Storage>::max();
+			if (scaled < -limit) return std::numeric_limits<Storage>::lowest();
+
+			return static_cast<storage_type>(scaled);
+		}
+
+		static float decode(storage_type bits)
+		{
+			return std::ldexp(static_cast<float>(bits), -FractionalBits);
+		}
+	};
+
+	// Element type of buffers stored in a narrower encoding. Converts implicitly from and to
+	// the value type, so kernels read decoded values and their results are encoded on write,
+	// while buffers, accessors and transfers only move the encoded bits.
+	template<typename Encoding>
+	struct encoded
+	{
+		using value_type = typename Encoding::value_type;
+		using storage_type = typename Encoding::storage_type;
+
+		encoded() = default;
+		encoded(value_type value) : bits(Encoding::encode(value)) {}
+
+		operator value_type() const { return Encoding::decode(bits); }
+
+		storage_type bits{};
+	};
+
+	using float16 = encoded<half_encoding>;
+
+	template<int FractionalBits, typename Storage = std::int16_t>
+	using fixed_point = encoded<fixed_point_encoding<FractionalBits, Storage>>;
+}
+
+#endif // ENCODING_H
@@ -0,0 +1,219 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "celerity.h"
+#include "policy.h"
+#include "profiler.h"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace celerity::algorithm
+{
+	namespace detail
+	{
+		using command_group = std::function<void(celerity::handler)>;
+
+		// value of a parameter for one replay; small trivially copyable values are stored
+		// inline, so binding them does not allocate
+		struct binding
+		{
+			const void* key;
+			std::shared_ptr<const void> shared;
+			alignas(std::max_align_t) unsigned char local[16];
+
+			const void* value() const { return shared ? shared.get() : local; }
+		};
+
+		struct binding_set
+		{
+			const binding* data = nullptr;
+			size_t size = 0;
+		};
+
+		// bindings of the replay whose command group executes on the calling thread, the mock
+		// hands them on to the workers running parts of the command group's kernels
+		inline const void*& current_bindings()
+		{
+#ifdef MOCK_CELERITY
+			return celerity::detail::kernel_context();
+#else
+			thread_local const void* b = nullptr;
+			return b;
+#endif
+		}
+
+		class binding_scope
+		{
+		public:
+			explicit binding_scope(binding_set b) : bindings_(b), previous_(std::exchange(current_bindings(), &bindings_)) {}
+			~binding_scope() { current_bindings() = previous_; }
+
+			binding_scope(const binding_scope&) = delete;
+			binding_scope& operator=(const binding_scope&) = delete;
+
+		private:
+			binding_set bindings_;
+			const void* previous_;
+		};
+
+		struct recorded_task
+		{
+			std::shared_ptr<const command_group> cgf;
+			const char* name;
+#ifdef MOCK_CELERITY
+			std::vector<celerity::detail::buffer_access> accesses;
+#endif
+		};
+
+		// tasks submitted on the calling thread while a graph is being recorded
+		inline std::vector<recorded_task>*& active_recording()
+		{
+			thread_local std::vector<recorded_task>* r = nullptr;
+			return r;
+		}
+
+		// Submits a distributed command group, recording it if a graph is being recorded.
+		// Every submission gets its own profile. Apart from recording and profiling, the
+		// command group is moved into the queue without further allocations.
+		template<typename F>
+		void submit_task(celerity::distr_queue& q, const char* name, F cgf)
+		{
+			if (auto recording = active_recording())
+			{
+				auto shared = std::make_shared<const command_group>(cgf);
+#ifdef MOCK_CELERITY
+				recording->push_back({ shared, name, celerity::detail::runtime::instance().record(*shared) });
+#else
+				recording->push_back({ shared, name });
+#endif
+			}
+
+			auto profile = task_profile::open(name, policy_name<distributed_execution_policy>::value);
+			q.submit([cgf = std::move(cgf), profile](celerity::handler cgh) { profiled(profile, [&]() { cgf(cgh); }); });
+		}
+
+		inline void ensure_not_recording()
+		{
+			if (active_recording())
+			{
+				throw std::logic_error("master access tasks deliver their results once and can not be recorded");
+			}
+		}
+	}
+
+	// Value that can change between replays of a task graph. get() returns the value bound by the
+	// replay that executes the calling command group (and, in the mock, its kernels), the initial
+	// value otherwise. Parameters must not change the regions a command group accesses.
+	template<typename T>
+	class parameter
+	{
+	public:
+		explicit parameter(T initial = {}) : initial_(std::make_shared<const T>(std::move(initial))) {}
+
+		const T& get() const
+		{
+			if (const auto b = static_cast<const detail::binding_set*>(detail::current_bindings()))
+			{
+				for (size_t i = 0; i < b->size; ++i)
+				{
+					if (b->data[i].key == initial_.get()) return *static_cast<const T*>(b->data[i].value());
+				}
+			}
+
+			return *initial_;
+		}
+
+		detail::binding bind(T value) const
+		{
+			detail::binding b{ initial_.get(), nullptr, {} };
+
+			if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(b.local) && alignof(T) <= alignof(std::max_align_t))
+			{
+				new (b.local) T(std::move(value));
+			}
+			else
+			{
+				b.shared = std::make_shared<const T>(std::move(value));
+			}
+
+			return b;
+		}
+
+	private:
+		std::shared_ptr<const T> initial_;
+	};
+
+	// Distributed tasks recorded once and submitted again by replay() without rebuilding
+	// command groups. The mock additionally reuses the accesses recorded for each task.
+	class task_graph
+	{
+	public:
+		explicit task_graph(std::vector<detail::recorded_task> tasks) : tasks_(std::move(tasks)) {}
+
+		// every command group keeps its own copy of the bindings, so replaying allocates nothing
+		// beyond what the queue needs per submission
+		template<typename...Bindings>
+		void replay(celerity::distr_queue q, Bindings...bindings) const
+		{
+			static_assert((std::is_same_v<Bindings, detail::binding> && ...), "replay takes bindings created by parameter::bind");
+
+			const std::array<detail::binding, sizeof...(Bindings)> bound{ std::move(bindings)... };
+
+			for (const auto& t : tasks_)
+			{
+				auto profile = task_profile::open(t.name, detail::policy_name<distributed_execution_policy>::value);
+
+				auto cgf = [cgf = t.cgf, bound, profile](celerity::handler cgh)
+				{
+					detail::binding_scope scope{ { bound.data(), bound.size() } };
+					profiled(profile, [&]() { (*cgf)(cgh); });
+				};
+
+#ifdef MOCK_CELERITY
+				q.submit(std::move(cgf), t.accesses);
+#else
+				q.submit(std::move(cgf));
+#endif
+			}
+		}
+
+		size_t size() const { return tasks_.size(); }
+
+	private:
+		std::vector<detail::recorded_task> tasks_;
+	};
+
+	// Records the distributed tasks f submits (they are executed as usual) into a task graph.
+	// Master access tasks can not be recorded.
+	template<typename F>
+	task_graph record(celerity::distr_queue q, const F& f)
+	{
+		std::vector<detail::recorded_task> tasks;
+
+		const auto previous = std::exchange(detail::active_recording(), &tasks);
+
+		try
+		{
+			f(q);
+		}
+		catch (...)
+		{
+			detail::active_recording() = previous;
+			throw;
+		}
+
+		detail::active_recording() = previous;
+
+		return task_graph{ std::move(tasks) };
+	}
+}
+
+#endif // GRAPH_H
@@ -0,0 +1,184 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "algorithm.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace celerity::algorithm
+{
+	namespace detail
+	{
+		template<typename KernelName> class histogram_count_kernel;
+		template<typename KernelName> class histogram_group_kernel;
+		template<typename KernelName> class histogram_merge_kernel;
+
+		// Maps a range of chunks to their rows of private bins
+		struct bin_rows_range_mapper
+		{
+			int bins;
+
+			subrange<1> operator()(celerity::chunk<1> chnk) const
+			{
+				return { { chnk.offset[0] * bins }, { chnk.range[0] * bins } };
+			}
+		};
+
+		// Maps a range of groups to the rows of private bins of their chunks
+		struct bin_groups_range_mapper
+		{
+			int bins;
+			int group_size;
+			int rows;
+
+			subrange<1> operator()(celerity::chunk<1> chnk) const
+			{
+				const auto first = std::min(chnk.offset[0] * group_size, rows);
+				const auto last = std::min((chnk.offset[0] + chnk.range[0]) * group_size, rows);
+
+				return { { first * bins }, { (last - first) * bins } };
+			}
+		};
+
+		template<typename C, typename Key, typename T>
+		void bin(C* bins, int count, const Key& key, const T& x)
+		{
+			const auto b = static_cast<long long>(key(x));
+
+			if (b >= 0 && b < count) ++bins[b];
+		}
+
+		// Distributed histogram with privatised bins, merged in two levels:
+		//   1. every chunk counts its elements into its own row of bins, no atomics required
+		//   2. every group of about sqrt(chunks) consecutive chunks sums its rows into one row
+		//   3. every range of bins sums its column over the rows of all groups
+		// Consecutive chunks are executed by the same node unless they straddle a node boundary,
+		// so the rows of step 1 are mostly merged where they were counted and only one row per
+		// group is transferred to the final merge.
+		template<typename ExecutionPolicy, typename T, typename C, typename Key>
+		void histogram(ExecutionPolicy p, iterator<T, 1> beg, iterator<T, 1> end, iterator<C, 1> bins_beg, iterator<C, 1> bins_end, const Key& key, cl::sycl::range<1> chunk_size)
+		{
+			using execution_policy = std::decay_t<ExecutionPolicy>;
+
+			const auto r = algorithm::detail::distance(beg, end);
+			const auto bins = algorithm::detail::distance(bins_beg, bins_end);
+			const auto n = bins[0];
+
+			if (n == 0) return;
+
+			if constexpr (!policy_traits<execution_policy>::is_distributed)
+			{
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto in_acc = get_access<execution_policy, access_mode::read, access_type::one_to_one>(cgh, beg, end);
+					auto out_acc = get_raw_access<access_mode::discard_write>(cgh, bins_beg.buffer(), bins, *bins_beg);
+
+					cgh.run([&]()
+					{
+						const auto out = out_acc.get_pointer() + (*bins_beg)[0];
+
+						std::fill(out, out + n, C{});
+						algorithm::detail::for_each_item(r, [&](auto item) { bin(out, n, key, in_acc[item]); });
+					});
+				}) | submit_to(p.q);
+			}
+			else
+			{
+				using kernel_name = typename policy_traits<execution_policy>::kernel_name;
+
+				const auto chunks = algorithm::detail::chunk_count(r, chunk_size)[0];
+				const auto group_size = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(chunks))));
+				const auto groups = (chunks + group_size - 1) / group_size;
+
+				// pending tasks hold a copy of the buffer, the leases only have to outlive the submissions
+				const auto partials_scratch = algorithm::detail::scratch<C>(cl::sycl::range<1>{ chunks * n });
+				const auto group_partials_scratch = algorithm::detail::scratch<C>(cl::sycl::range<1>{ groups * n });
+				auto partials = *partials_scratch;
+				auto group_partials = *group_partials_scratch;
+
+				const auto all_group_partials = celerity::access::fixed<1>({ { 0 }, group_partials.get_range() });
+
+				// 1. private bins per chunk
+
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto in_acc = get_access<execution_policy, access_mode::read, access_type::chunk>(cgh, beg, end, chunk_size);
+					auto rows_acc = get_raw_access<access_mode::discard_write>(cgh, partials, bin_rows_range_mapper{ n }, partials.get_range());
+
+					cgh.parallel_for<histogram_count_kernel<kernel_name>>(cl::sycl::range<1>{ chunks }, [&](auto item)
+					{
+						const auto in = in_acc[item];
+						const auto row = rows_acc.get_pointer() + item[0] * n;
+
+						std::fill(row, row + n, C{});
+						std::for_each(in.begin(), in.end(), [&](const T& x) { bin(row, n, key, x); });
+					});
+				}) | submit_to(p.q);
+
+				// 2. merge of the rows of each group
+
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto rows_acc = get_raw_access<access_mode::read>(cgh, partials, bin_groups_range_mapper{ n, group_size, chunks }, partials.get_range());
+					auto out_acc = get_raw_access<access_mode::discard_write>(cgh, group_partials, bin_rows_range_mapper{ n }, group_partials.get_range());
+
+					cgh.parallel_for<histogram_group_kernel<kernel_name>>(cl::sycl::range<1>{ groups }, [&](auto item)
+					{
+						const auto first = item[0] * group_size;
+						const auto last = std::min(first + group_size, chunks);
+						const auto out = out_acc.get_pointer() + item[0] * n;
+
+						std::copy_n(rows_acc.get_pointer() + first * n, n, out);
+
+						for (auto i = first + 1; i < last; ++i)
+						{
+							const auto row = rows_acc.get_pointer() + i * n;
+							std::transform(out, out + n, row, out, [](const C& lhs, const C& rhs) { return lhs + rhs; });
+						}
+					});
+				}) | submit_to(p.q);
+
+				// 3. merge of the group rows
+
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto rows_acc = get_raw_access<access_mode::read>(cgh, group_partials, all_group_partials, group_partials.get_range());
+					auto out_acc = get_access<execution_policy, access_mode::discard_write, access_type::one_to_one>(cgh, bins_beg, bins);
+
+					cgh.parallel_for<histogram_merge_kernel<kernel_name>>(bins, [&](auto item)
+					{
+						const auto rows = rows_acc.get_pointer();
+
+						auto sum = C{};
+						for (auto i = 0; i < groups; ++i)
+						{
+							sum += rows[i * n + item[0]];
+						}
+
+						out_acc[item] = sum;
+					});
+				}) | submit_to(p.q);
+			}
+		}
+	}
+
+	// Counts the elements per bin key(x) into [bins_beg, bins_end); keys outside the bins are ignored.
+	template<typename ExecutionPolicy, typename T, typename C, size_t Rank, typename Key>
+	void histogram(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<C, Rank> bins_beg, iterator<C, Rank> bins_end, const Key& key)
+	{
+		static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+
+		detail::histogram(p, beg, end, bins_beg, bins_end, key, detail::default_chunk_size(detail::distance(beg, end)));
+	}
+
+	template<typename ExecutionPolicy, typename T, typename C, size_t Rank, typename Key>
+	void histogram(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, iterator<C, Rank> bins_beg, iterator<C, Rank> bins_end, const Key& key, cl::sycl::range<Rank> chunk_size)
+	{
+		static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+
+		detail::histogram(p, beg, end, bins_beg, bins_end, key, chunk_size);
+	}
+}
+
+#endif // HISTOGRAM_H
@@ -4,59 +4,245 @@
 #include "celerity.h"
 #include <stdexcept>
 #include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 
 namespace celerity::algorithm
 {
-	template<typename T, size_t Dims>
-	class iterator;
+	namespace detail
+	{
+		template<size_t Rank>
+		int count(const cl::sycl::range<Rank>& r)
+		{
+			auto n = 1;
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				n *= r[i];
+			}
+			return n;
+		}
+
+		template<size_t Rank>
+		int linearize(const cl::sycl::id<Rank>& idx, const cl::sycl::range<Rank>& r)
+		{
+			auto offset = 0;
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				offset = offset * r[i] + idx[i];
+			}
+			return offset;
+		}
 
-	template<typename T>
-	class iterator<T, 1>
+		// inverse of linearize; the first dimension is not wrapped so that
+		// the position one past the last row can be represented
+		template<size_t Rank>
+		cl::sycl::id<Rank> delinearize(int offset, const cl::sycl::range<Rank>& r)
+		{
+			cl::sycl::id<Rank> idx{};
+			for (auto i = Rank - 1; i > 0; --i)
+			{
+				idx[i] = offset % r[i];
+				offset /= r[i];
+			}
+			idx[0] = offset;
+			return idx;
+		}
+
+		// advances pos to the next position in row-major order, 
+		// i.e. the last dimension is the fastest moving one
+		template<size_t Rank>
+		void increment(cl::sycl::id<Rank>& pos, const cl::sycl::range<Rank>& r)
+		{
+			for (auto i = Rank - 1; i > 0; --i)
+			{
+				if (++pos[i] < r[i])
+				{
+					return;
+				}
+
+				pos[i] = 0;
+			}
+
+			++pos[0];
+		}
+
+		// number of chunks of size chunk_size needed to cover r in each dimension
+		template<size_t Rank>
+		cl::sycl::range<Rank> chunk_count(const cl::sycl::range<Rank>& r, const cl::sycl::range<Rank>& chunk_size)
+		{
+			auto chunks = r;
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				assert(chunk_size[i] > 0);
+				chunks[i] = (r[i] + chunk_size[i] - 1) / chunk_size[i];
+			}
+			return chunks;
+		}
+
+		inline constexpr auto default_chunks = 32;
+
+		// splits r along its first dimension only, so chunks span whole rows and stay contiguous
+		template<size_t Rank>
+		cl::sycl::range<Rank> default_chunk_size(const cl::sycl::range<Rank>& r)
+		{
+			auto chunk_size = r;
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				chunk_size[i] = std::max(1, r[i]);
+			}
+
+			chunk_size[0] = std::max(1, (r[0] + default_chunks - 1) / default_chunks);
+			return chunk_size;
+		}
+
+		// host-side equivalent of parallel_for used by master tasks
+		template<size_t Rank, typename F>
+		void for_each_item(const cl::sycl::range<Rank>& r, const F& f)
+		{
+			if (count(r) == 0) return;
+
+			for (cl::sycl::item<Rank> item{}; item[0] < r[0]; increment(item, r))
+			{
+				f(item);
+			}
+		}
+	}
+
+	// random-access iterator over the positions of a buffer in row-major order
+	template<typename T, size_t Rank>
+	class iterator
 	{
 	public:
-		iterator(int pos, celerity::buffer<T, 1> & buffer)
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = cl::sycl::id<Rank>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = cl::sycl::id<Rank>;
+
+		iterator(cl::sycl::id<Rank> pos, celerity::buffer<T, Rank> buffer)
 			: pos_(pos),
-			buffer_(buffer)
+			buffer_(std::move(buffer))
 		{
 		}
 
-		bool operator ==(const iterator& rhs)
+		bool operator ==(const iterator& rhs) const
 		{
 			return pos_ == rhs.pos_;
 		}
 
-		bool operator !=(const iterator& rhs)
+		bool operator !=(const iterator& rhs) const
 		{
 			return pos_ != rhs.pos_;
 		}
 
+		bool operator <(const iterator& rhs) const { return *this - rhs < 0; }
+		bool operator >(const iterator& rhs) const { return rhs < *this; }
+		bool operator <=(const iterator& rhs) const { return !(rhs < *this); }
+		bool operator >=(const iterator& rhs) const { return !(*this < rhs); }
+
 		iterator& operator++()
 		{
-			pos_++; return *this;
+			detail::increment(pos_, buffer_.get_range());
+			return *this;
 		}
 
-		[[nodiscard]] int operator*() const { return pos_; }
-		[[nodiscard]] celerity::buffer<T, 1> & buffer() const { return buffer_; }
+		iterator operator++(int)
+		{
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		iterator& operator--() { return *this -= 1; }
+
+		iterator operator--(int)
+		{
+			auto it = *this;
+			--*this;
+			return it;
+		}
+
+		iterator& operator+=(difference_type n)
+		{
+			pos_ = detail::delinearize(detail::linearize(pos_, buffer_.get_range()) + static_cast<int>(n), buffer_.get_range());
+			return *this;
+		}
+
+		iterator& operator-=(difference_type n) { return *this += -n; }
+
+		iterator operator+(difference_type n) const { return iterator{ *this } += n; }
+		iterator operator-(difference_type n) const { return iterator{ *this } -= n; }
+		friend iterator operator+(difference_type n, const iterator& it) { return it + n; }
+
+		difference_type operator-(const iterator& rhs) const
+		{
+			assert(buffer_.get_range() == rhs.buffer_.get_range());
+			return detail::linearize(pos_, buffer_.get_range()) - detail::linearize(rhs.pos_, buffer_.get_range());
+		}
+
+		cl::sycl::id<Rank> operator[](difference_type n) const { return *(*this + n); }
+
+		[[nodiscard]] cl::sycl::id<Rank> operator*() const { return pos_; }
+		// buffers are handles, so the iterator keeps the buffer alive for pending tasks
+		[[nodiscard]] celerity::buffer<T, Rank> buffer() const { return buffer_; }
 
 	private:
-		int pos_ = 0;
-		celerity::buffer<T, 1>& buffer_;
+		cl::sycl::id<Rank> pos_;
+		celerity::buffer<T, Rank> buffer_;
 	};
+
+	namespace detail
+	{
+		// Returns the range spanned by [beg, end). For Rank > 1 both iterators
+		// have to point to the start of a row, i.e. the range covers whole rows.
+		template<typename T, size_t Rank>
+		cl::sycl::range<Rank> distance(const iterator<T, Rank>& beg, const iterator<T, Rank>& end)
+		{
+			assert(beg.buffer().get_range() == end.buffer().get_range());
+			assert((*beg)[0] <= (*end)[0]);
+
+			for (size_t i = 1; i < Rank; ++i)
+			{
+				assert((*beg)[i] == 0 && (*end)[i] == 0 && "iterators have to be aligned to rows");
+			}
+
+			auto r = beg.buffer().get_range();
+			r[0] = (*end)[0] - (*beg)[0];
+			return r;
+		}
+
+		template<typename T, size_t Rank>
+		bool fits(const iterator<T, Rank>& it, cl::sycl::range<Rank> r)
+		{
+			const auto buffer_range = it.buffer().get_range();
+
+			for (size_t i = 0; i < Rank; ++i)
+			{
+				if ((*it)[i] + r[i] > buffer_range[i]) return false;
+			}
+
+			return true;
+		}
+	}
 }
 
 namespace celerity
 {
-	template<typename T>
-	algorithm::iterator<T, 1> begin(celerity::buffer<T, 1> & buffer)
+	template<typename T, size_t Rank>
+	algorithm::iterator<T, Rank> begin(celerity::buffer<T, Rank> & buffer)
 	{
-		return algorithm::iterator<T, 1>(0, buffer);
+		return algorithm::iterator<T, Rank>(cl::sycl::id<Rank>{}, buffer);
 	}
 
-	template<typename T>
-	algorithm::iterator<T, 1> end(celerity::buffer<T, 1> & buffer)
+	template<typename T, size_t Rank>
+	algorithm::iterator<T, Rank> end(celerity::buffer<T, Rank> & buffer)
 	{
-		return algorithm::iterator<T, 1>(static_cast<int>(buffer.size()), buffer);
+		cl::sycl::id<Rank> pos{};
+		pos[0] = buffer.get_range()[0];
+
+		return algorithm::iterator<T, Rank>(pos, buffer);
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
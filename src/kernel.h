@@ -19,9 +19,9 @@ public:
 		auto output = algorithm::fixed::create_accessor<access_mode::write>(cgh, output_view_);
 		auto input = algorithm::fixed::create_accessor<access_mode::read>(cgh, input_view_);
 
-		cgh.parallel_for<class test>(input_view_.range(), [=](auto item)
+		cgh.parallel_for<class test>(input_view_.range(), [&](auto item)
 		{
-			auto r = f_(input[item]);
+			output[item] = f_(input[item]);
 		});
 	}
 
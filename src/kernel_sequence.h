@@ -10,7 +10,7 @@ namespace celerity::algorithm
 	class kernel_sequence
 	{
 	public:
-		kernel_sequence(sequence<Actions...>&& s)
+		kernel_sequence(celerity::algorithm::sequence<Actions...>&& s)
 			: sequence_(std::move(s)) { }
 
 		decltype(auto) operator()(handler& cgh) const
@@ -18,7 +18,8 @@ namespace celerity::algorithm
 			return std::invoke(sequence_, cgh);
 		}
 
-		auto sequence() { return sequence_; }
+		const celerity::algorithm::sequence<Actions...>& sequence() const & { return sequence_; }
+		celerity::algorithm::sequence<Actions...> sequence() && { return std::move(sequence_); }
 
 	private:
 		celerity::algorithm::sequence<Actions...> sequence_;
@@ -27,8 +28,7 @@ namespace celerity::algorithm
 	template<typename...Ts, typename...Us>
 	auto operator | (kernel_sequence<Ts...>&& lhs, kernel_sequence<Us...>&& rhs)
 	{
-		auto seq = lhs.sequence() | rhs.sequence();
-		return kernel_sequence<Ts..., Us...>{ seq };
+		return kernel_sequence<Ts..., Us...>{ { std::move(lhs).sequence(), std::move(rhs).sequence() } };
 	}
 
 	template<typename...Actions>
@@ -0,0 +1,160 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "algorithm.h"
+
+#include <algorithm>
+
+namespace celerity::algorithm
+{
+	namespace detail
+	{
+		// rows and columns of c computed by one work item
+		inline constexpr auto default_gemm_tile = 32;
+
+		// columns of a (rows of b) processed per step, sized so that a block of b stays in cache
+		inline constexpr auto default_gemm_k_block = 128;
+
+		// Maps a chunk of the tile grid of c to the band of a matrix it depends on:
+		// the rows (dim = 0) or columns (dim = 1) covered by the tiles, spanning the other dimension completely
+		struct tile_band_range_mapper
+		{
+			cl::sycl::id<2> offset;
+			cl::sycl::range<2> range;
+			int tile;
+			size_t dim;
+
+			subrange<2> operator()(celerity::chunk<2> chnk) const
+			{
+				subrange<2> sr{ offset, range };
+
+				const auto first = chnk.offset[dim] * tile;
+				const auto last = std::min((chnk.offset[dim] + chnk.range[dim]) * tile, range[dim]);
+
+				sr.offset[dim] += first;
+				sr.range[dim] = last - first;
+
+				return sr;
+			}
+		};
+
+		// c[tile] = a[tile rows, :] * b[:, tile cols] in i-k-j order, blocked along k
+		template<typename T>
+		void gemm_tile(const T* a, const T* b, T* c,
+			cl::sycl::id<2> a_off, cl::sycl::range<2> a_buf,
+			cl::sycl::id<2> b_off, cl::sycl::range<2> b_buf,
+			cl::sycl::id<2> c_off, cl::sycl::range<2> c_buf,
+			cl::sycl::id<2> first, cl::sycl::id<2> last, int k_extent)
+		{
+			const auto row = [](auto* base, cl::sycl::id<2> off, cl::sycl::range<2> buf, int i)
+			{
+				return base + linearize(cl::sycl::id<2>{ off[0] + i, off[1] }, buf);
+			};
+
+			for (auto i = first[0]; i < last[0]; ++i)
+			{
+				std::fill(row(c, c_off, c_buf, i) + first[1], row(c, c_off, c_buf, i) + last[1], T{});
+			}
+
+			for (auto kk = 0; kk < k_extent; kk += default_gemm_k_block)
+			{
+				const auto k_last = std::min(kk + default_gemm_k_block, k_extent);
+
+				for (auto i = first[0]; i < last[0]; ++i)
+				{
+					const auto a_row = row(a, a_off, a_buf, i);
+					const auto c_row = row(c, c_off, c_buf, i);
+
+					for (auto k = kk; k < k_last; ++k)
+					{
+						const auto a_ik = a_row[k];
+						const auto b_row = row(b, b_off, b_buf, k);
+
+						for (auto j = first[1]; j < last[1]; ++j)
+						{
+							c_row[j] += a_ik * b_row[j];
+						}
+					}
+				}
+			}
+		}
+
+		template<typename ExecutionPolicy, typename T>
+		auto gemm(ExecutionPolicy p, iterator<T, 2> a_beg, iterator<T, 2> a_end, iterator<T, 2> b_beg, iterator<T, 2> b_end, iterator<T, 2> c_beg, int tile)
+		{
+			using execution_policy = std::decay_t<ExecutionPolicy>;
+
+			const auto a_r = distance(a_beg, a_end);
+			const auto b_r = distance(b_beg, b_end);
+			const cl::sycl::range<2> c_r{ a_r[0], b_r[1] };
+
+			assert(a_r[1] == b_r[0]);
+			assert(fits(c_beg, c_r));
+			assert(tile > 0);
+
+			const auto tiles = chunk_count(c_r, cl::sycl::range<2>{ tile, tile });
+
+			return [=](celerity::handler cgh)
+			{
+				const auto a_buf = a_beg.buffer().get_range();
+				const auto b_buf = b_beg.buffer().get_range();
+				const auto c_buf = c_beg.buffer().get_range();
+
+				const auto kernel = [=](auto a_acc, auto b_acc, auto c_acc, cl::sycl::id<2> t)
+				{
+					const cl::sycl::id<2> first{ t[0] * tile, t[1] * tile };
+					const cl::sycl::id<2> last{ std::min(first[0] + tile, c_r[0]), std::min(first[1] + tile, c_r[1]) };
+
+					gemm_tile<T>(a_acc.get_pointer(), b_acc.get_pointer(), c_acc.get_pointer(),
+						*a_beg, a_buf, *b_beg, b_buf, *c_beg, c_buf, first, last, a_r[1]);
+				};
+
+				if constexpr (policy_traits<execution_policy>::is_distributed)
+				{
+					auto a_acc = get_raw_access<celerity::access_mode::read>(cgh, a_beg.buffer(), tile_band_range_mapper{ *a_beg, a_r, tile, 0 }, a_r);
+					auto b_acc = get_raw_access<celerity::access_mode::read>(cgh, b_beg.buffer(), tile_band_range_mapper{ *b_beg, b_r, tile, 1 }, b_r);
+					auto c_acc = get_raw_access<celerity::access_mode::discard_write>(cgh, c_beg.buffer(), chunk_range_mapper<2>{ *c_beg, c_r, { tile, tile } }, c_r);
+
+					cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(tiles, [=](auto item)
+						{
+							kernel(a_acc, b_acc, c_acc, item);
+						});
+				}
+				else
+				{
+					auto a_acc = get_raw_access<celerity::access_mode::read>(cgh, a_beg.buffer(), a_r, *a_beg);
+					auto b_acc = get_raw_access<celerity::access_mode::read>(cgh, b_beg.buffer(), b_r, *b_beg);
+					auto c_acc = get_raw_access<celerity::access_mode::discard_write>(cgh, c_beg.buffer(), c_r, *c_beg);
+
+					cgh.run([&]()
+						{
+							for_each_item(tiles, [&](auto item)
+								{
+									kernel(a_acc, b_acc, c_acc, item);
+								});
+						});
+				}
+			};
+		}
+	}
+
+	namespace actions
+	{
+		template<typename ExecutionPolicy, typename T>
+		auto gemm(ExecutionPolicy p, iterator<T, 2> a_beg, iterator<T, 2> a_end, iterator<T, 2> b_beg, iterator<T, 2> b_end, iterator<T, 2> c_beg,
+			int tile = algorithm::detail::default_gemm_tile)
+		{
+			return task(p, algorithm::detail::gemm(p, a_beg, a_end, b_beg, b_end, c_beg, tile));
+		}
+	}
+
+	// c = a * b for row-major matrices, one tile x tile block of c per work item
+	template<typename ExecutionPolicy, typename T>
+	void gemm(ExecutionPolicy p, iterator<T, 2> a_beg, iterator<T, 2> a_end, iterator<T, 2> b_beg, iterator<T, 2> b_end, iterator<T, 2> c_beg,
+		int tile = detail::default_gemm_tile)
+	{
+		actions::gemm(p, a_beg, a_end, b_beg, b_end, c_beg, tile) | submit_to(p.q);
+	}
+}
+
+#endif // MATRIX_H
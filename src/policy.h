@@ -2,6 +2,7 @@
 #define POLICY_H
 
 #include "celerity.h"
+#include "split.h"
 
 namespace celerity::algorithm
 {
@@ -14,9 +15,13 @@ struct distributed_execution_policy
 template<typename KernelName>
 struct named_distributed_execution_policy : distributed_execution_policy
 {
-	explicit named_distributed_execution_policy(distr_queue& queue) : q(queue) {}
+	explicit named_distributed_execution_policy(distr_queue& queue, std::shared_ptr<split_strategy> strategy = nullptr)
+		: q(queue), split(std::move(strategy)) {}
 
 	::celerity::distr_queue q;
+
+	// how the tasks of this policy are split across nodes, the runtime decides if empty
+	std::shared_ptr<split_strategy> split;
 };
 
 struct non_blocking_master_execution_policy
@@ -78,6 +83,13 @@ using decay_policy_t = typename decay_policy<T>::type;
 template<typename KernelName>
 auto distr(::celerity::distr_queue q) { return named_distributed_execution_policy<KernelName>{q}; }
 
+// tasks created with this policy are split by the given strategy
+template<typename KernelName>
+auto distr(::celerity::distr_queue q, std::shared_ptr<split_strategy> split)
+{
+	return named_distributed_execution_policy<KernelName>{ q, std::move(split) };
+}
+
 inline auto master(celerity::distr_queue q) { return non_blocking_master_execution_policy{ q }; }
 inline auto master_blocking(celerity::distr_queue q) { return blocking_master_execution_policy{ q }; }
 
@@ -0,0 +1,295 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "celerity.h"
+#include "policy.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace celerity::algorithm
+{
+	namespace detail
+	{
+		template<typename KernelName>
+		const char* kernel_name()
+		{
+			static const std::string name = []()
+			{
+				// kernel names are usually incomplete types, which only typeid of a pointer accepts
+				std::string mangled = typeid(KernelName*).name();
+#if defined(__GNUG__)
+				int status = 0;
+				char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+
+				if (status == 0 && demangled)
+				{
+					mangled = demangled;
+					mangled.pop_back();
+				}
+
+				std::free(demangled);
+#endif
+				return mangled;
+			}();
+
+			return name.c_str();
+		}
+
+		template<typename ExecutionPolicy>
+		struct policy_name
+		{
+			static constexpr const char* value = "distributed";
+		};
+
+		template<>
+		struct policy_name<non_blocking_master_execution_policy>
+		{
+			static constexpr const char* value = "master";
+		};
+
+		template<>
+		struct policy_name<blocking_master_execution_policy>
+		{
+			static constexpr const char* value = "master_blocking";
+		};
+
+		template<typename ExecutionPolicy>
+		struct task_name
+		{
+			static const char* get() { return policy_name<ExecutionPolicy>::value; }
+		};
+
+		template<typename KernelName>
+		struct task_name<named_distributed_execution_policy<KernelName>>
+		{
+			static const char* get() { return kernel_name<KernelName>(); }
+		};
+
+		template<celerity::access_mode Mode>
+		constexpr const char* access_mode_name()
+		{
+			if constexpr (Mode == celerity::access_mode::read) return "read";
+			else if constexpr (Mode == celerity::access_mode::write) return "write";
+			else if constexpr (Mode == celerity::access_mode::discard_write) return "discard_write";
+			else return "read_write";
+		}
+	}
+
+	// Collects timings and accessor requests of submitted tasks while enabled.
+	// Disabled by default; a disabled profiler costs one atomic load per submission.
+	class profiler
+	{
+	public:
+		using clock = std::chrono::steady_clock;
+
+		struct access_record
+		{
+			const char* mode;
+			size_t bytes;
+		};
+
+		struct task_record
+		{
+			const char* name;
+			const char* policy;
+			clock::time_point submit;
+			clock::time_point start;
+			clock::time_point end;
+			int thread;
+			std::vector<access_record> accesses;
+		};
+
+		// never destroyed, tasks may still complete during static destruction
+		static profiler& instance()
+		{
+			static auto p = new profiler;
+			return *p;
+		}
+
+		void enable() { enabled_ = true; }
+		void disable() { enabled_ = false; }
+		bool enabled() const { return enabled_; }
+
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			records_.clear();
+		}
+
+		void commit(task_record&& record)
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			records_.push_back(std::move(record));
+		}
+
+		std::vector<task_record> records() const
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			return records_;
+		}
+
+		// writes the recorded tasks in the Chrome trace event format (chrome://tracing, Perfetto)
+		void write_chrome_trace(std::ostream& os) const
+		{
+			const auto us = [this](clock::time_point t)
+			{
+				return std::chrono::duration_cast<std::chrono::microseconds>(t - origin_).count();
+			};
+
+			std::lock_guard<std::mutex> lock{ mutex_ };
+
+			os << "{\"traceEvents\":[";
+
+			for (size_t i = 0; i < records_.size(); ++i)
+			{
+				const auto& r = records_[i];
+
+				size_t bytes = 0;
+				for (const auto& a : r.accesses) bytes += a.bytes;
+
+				os << (i == 0 ? "" : ",") << "\n{\"name\":\"" << escape(r.name) << "\",\"cat\":\"" << r.policy << "\",\"ph\":\"X\""
+					<< ",\"ts\":" << us(r.start) << ",\"dur\":" << us(r.end) - us(r.start)
+					<< ",\"pid\":0,\"tid\":" << r.thread << ",\"args\":{\"submit_us\":" << us(r.submit)
+					<< ",\"queued_us\":" << us(r.start) - us(r.submit)
+					<< ",\"bytes\":" << bytes << ",\"accessors\":[";
+
+				for (size_t j = 0; j < r.accesses.size(); ++j)
+				{
+					os << (j == 0 ? "" : ",") << "{\"mode\":\"" << r.accesses[j].mode << "\",\"bytes\":" << r.accesses[j].bytes << "}";
+				}
+
+				os << "]}}";
+			}
+
+			os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		}
+
+	private:
+		profiler() : origin_(clock::now()) {}
+
+		static std::string escape(const char* s)
+		{
+			std::string out;
+			for (; *s; ++s)
+			{
+				if (*s == '"' || *s == '\\') out += '\\';
+				out += *s;
+			}
+			return out;
+		}
+
+		std::atomic<bool> enabled_{ false };
+		clock::time_point origin_;
+		mutable std::mutex mutex_;
+		std::vector<task_record> records_;
+	};
+
+	// Profile of a single submission, committed to the profiler once the last copy of the
+	// command group holding it is released. Accessor requests are attributed to the task
+	// currently executing on the calling thread; every pass over the command group restarts
+	// the record, so the last (live) pass determines timings and accesses.
+	class task_profile
+	{
+	public:
+		task_profile(const char* name, const char* policy)
+		{
+			record_.name = name;
+			record_.policy = policy;
+			record_.submit = profiler::clock::now();
+		}
+
+		task_profile(const task_profile&) = delete;
+		task_profile& operator=(const task_profile&) = delete;
+
+		~task_profile()
+		{
+			profiler::instance().commit(std::move(record_));
+		}
+
+		// returns nullptr while the profiler is disabled
+		static std::shared_ptr<task_profile> open(const char* name, const char* policy)
+		{
+			if (!profiler::instance().enabled()) return nullptr;
+
+			return std::make_shared<task_profile>(name, policy);
+		}
+
+		template<typename F>
+		decltype(auto) run(const F& f)
+		{
+			struct scope
+			{
+				task_profile& p;
+				task_profile* previous;
+
+				scope(task_profile& p) : p(p), previous(current())
+				{
+					current() = &p;
+					p.record_.accesses.clear();
+					p.record_.start = profiler::clock::now();
+					p.record_.thread = thread_index();
+				}
+
+				~scope()
+				{
+					p.record_.end = profiler::clock::now();
+					current() = previous;
+				}
+			};
+
+			scope s{ *this };
+			return f();
+		}
+
+		template<celerity::access_mode Mode, typename T, size_t Rank>
+		static void record_access(const cl::sycl::range<Rank>& r)
+		{
+			if (auto p = current())
+			{
+				size_t elements = 1;
+				for (size_t i = 0; i < Rank; ++i) elements *= r[i];
+
+				p->record_.accesses.push_back({ detail::access_mode_name<Mode>(), elements * sizeof(T) });
+			}
+		}
+
+	private:
+		// small per-thread number, used as trace row
+		static int thread_index()
+		{
+			static std::atomic<int> next{ 0 };
+			thread_local const int index = next++;
+			return index;
+		}
+
+		static task_profile*& current()
+		{
+			thread_local task_profile* p = nullptr;
+			return p;
+		}
+
+		profiler::task_record record_{};
+	};
+
+	template<typename F>
+	decltype(auto) profiled(const std::shared_ptr<task_profile>& profile, const F& f)
+	{
+		if (!profile) return f();
+
+		return profile->run(f);
+	}
+}
+
+#endif // PROFILER_H
@@ -0,0 +1,172 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include "celerity.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <typeindex>
+
+namespace celerity::algorithm
+{
+	// Buffers for library-internal temporaries, reused across invocations instead of being
+	// allocated (and first touched) every time. A buffer leaves the pool for as long as a copy
+	// of its lease exists; algorithms keep the lease in the command groups or sequence using it.
+	// Contents of a leased buffer are unspecified. Handing a buffer out again while tasks of its
+	// previous user are pending is safe, the runtime orders the conflicting accesses.
+	// Idle buffers are kept up to an idle limit in bytes; the ones idle for longest are freed first.
+	class scratch_pool
+	{
+	public:
+		template<typename T, size_t Rank>
+		using lease = std::shared_ptr<celerity::buffer<T, Rank>>;
+
+		struct statistics
+		{
+			size_t allocations = 0;
+			size_t reuses = 0;
+			size_t evictions = 0;
+		};
+
+		static constexpr size_t default_idle_limit = size_t{ 256 } << 20;
+
+		// never destroyed, leases may still be released during static destruction
+		static scratch_pool& instance()
+		{
+			static auto p = new scratch_pool;
+			return *p;
+		}
+
+		template<typename T, size_t Rank>
+		lease<T, Rank> acquire(cl::sycl::range<Rank> r)
+		{
+			const auto k = make_key<T>(r);
+
+			celerity::buffer<T, Rank>* b = nullptr;
+
+			{
+				std::lock_guard<std::mutex> lock{ mutex_ };
+
+				if (auto it = idle_.find(k); it != idle_.end())
+				{
+					b = static_cast<celerity::buffer<T, Rank>*>(it->second.buffer.release());
+					idle_bytes_ -= it->second.bytes;
+					idle_.erase(it);
+					++stats_.reuses;
+				}
+				else
+				{
+					++stats_.allocations;
+				}
+			}
+
+			if (!b)
+			{
+				b = new celerity::buffer<T, Rank>{ r };
+			}
+
+			return lease<T, Rank>(b, [this, k](celerity::buffer<T, Rank>* b)
+				{
+					const auto bytes = b->size() * sizeof(T);
+
+					std::lock_guard<std::mutex> lock{ mutex_ };
+
+					idle_.emplace(k, entry{ { b, [](void* p) { delete static_cast<celerity::buffer<T, Rank>*>(p); } }, bytes, ++releases_ });
+					idle_bytes_ += bytes;
+
+					trim();
+				});
+		}
+
+		// releases the idle buffers
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			idle_.clear();
+			idle_bytes_ = 0;
+		}
+
+		// frees idle buffers until at most bytes are idle, and keeps it so for buffers released later
+		void set_idle_limit(size_t bytes)
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			idle_limit_ = bytes;
+			trim();
+		}
+
+		size_t idle_bytes() const
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			return idle_bytes_;
+		}
+
+		size_t idle() const
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			return idle_.size();
+		}
+
+		statistics stats() const
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			return stats_;
+		}
+
+	private:
+		using key = std::tuple<std::type_index, size_t, std::array<int, 3>>;
+
+		struct entry
+		{
+			std::unique_ptr<void, void(*)(void*)> buffer;
+			size_t bytes;
+			size_t released;
+		};
+
+		scratch_pool() = default;
+
+		// frees the least recently released buffers while over the limit, called with mutex_ held
+		void trim()
+		{
+			while (idle_bytes_ > idle_limit_)
+			{
+				const auto oldest = std::min_element(idle_.begin(), idle_.end(),
+					[](const auto& lhs, const auto& rhs) { return lhs.second.released < rhs.second.released; });
+
+				idle_bytes_ -= oldest->second.bytes;
+				idle_.erase(oldest);
+				++stats_.evictions;
+			}
+		}
+
+		template<typename T, size_t Rank>
+		static key make_key(const cl::sycl::range<Rank>& r)
+		{
+			std::array<int, 3> padded{ 1, 1, 1 };
+			std::copy_n(r.begin(), Rank, padded.begin());
+
+			return { std::type_index{ typeid(T) }, Rank, padded };
+		}
+
+		mutable std::mutex mutex_;
+		std::multimap<key, entry> idle_;
+		size_t idle_bytes_ = 0;
+		size_t idle_limit_ = default_idle_limit;
+		size_t releases_ = 0;
+		statistics stats_;
+	};
+
+	namespace detail
+	{
+		template<typename T, size_t Rank>
+		scratch_pool::lease<T, Rank> scratch(cl::sycl::range<Rank> r)
+		{
+			return scratch_pool::instance().acquire<T>(r);
+		}
+	}
+}
+
+#endif // SCRATCH_H
@@ -20,15 +20,23 @@ namespace celerity::algorithm
 		using actions_t = std::tuple<Actions...>;
 		static constexpr auto num_actions = sizeof...(Actions);
 
+		// actions are moved through the composition, only lvalue operands are copied (once)
 		sequence(Actions... actions)
-			: actions_(actions...)
+			: actions_(std::move(actions)...)
 		{
 
 		}
 
 		template<typename...SequenceActions, typename Action>
 		sequence(sequence<SequenceActions...>&& seq, Action action)
-			: sequence(std::move(seq), action, std::index_sequence_for<SequenceActions...>{})
+			: sequence(std::move(seq), std::move(action), std::index_sequence_for<SequenceActions...>{})
+		{
+
+		}
+
+		template<typename...Ts, typename...Us>
+		sequence(sequence<Ts...>&& lhs, sequence<Us...>&& rhs)
+			: sequence(std::move(lhs), std::move(rhs), std::index_sequence_for<Ts...>{}, std::index_sequence_for<Us...>{})
 		{
 
 		}
@@ -45,13 +53,20 @@ namespace celerity::algorithm
 		}
 
 		constexpr actions_t& actions() { return actions_; }
+		constexpr const actions_t& actions() const { return actions_; }
 
 	private:
 		actions_t actions_;
 
 		template<typename...SequenceActions, typename Action, size_t...Ids>
 		sequence(sequence<SequenceActions...>&& sequence, Action action, std::index_sequence<Ids...>)
-			: actions_(std::move(std::get<Ids>(sequence.actions()))..., action)
+			: actions_(std::move(std::get<Ids>(sequence.actions()))..., std::move(action))
+		{
+		}
+
+		template<typename...Ts, typename...Us, size_t...Lhs, size_t...Rhs>
+		sequence(sequence<Ts...>&& lhs, sequence<Us...>&& rhs, std::index_sequence<Lhs...>, std::index_sequence<Rhs...>)
+			: actions_(std::move(std::get<Lhs>(lhs.actions()))..., std::move(std::get<Rhs>(rhs.actions()))...)
 		{
 		}
 
@@ -99,12 +114,16 @@ namespace celerity::algorithm
 		using is_sequence_type = std::integral_constant<bool, true>;
 	};
 
-	template<template <typename...> typename T, template <typename...> typename U,
+	// sequences accept any arguments, but are submitted as a whole instead of as a kernel
+	template<typename...Actions>
+	struct is_kernel<algorithm::sequence<Actions...>> : std::false_type {};
+
+	template<template <typename...> typename T,
 		typename...Ts, typename...Us,
-		typename = std::enable_if_t<is_sequence_v<T<Ts...>> && is_sequence_v<U<Us...>>>>
+		typename = std::enable_if_t<is_sequence_v<T<Ts...>> && is_sequence_v<T<Us...>>>>
 		auto operator | (T<Ts...> && lhs, T<Us...> && rhs)
 	{
-		return sequence<Ts..., Us...>{ lhs, rhs };
+		return sequence<Ts..., Us...>{ std::move(lhs), std::move(rhs) };
 	}
 }
 
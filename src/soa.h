@@ -0,0 +1,253 @@
+#ifndef SOA_H
+#define SOA_H
+
+#include "algorithm.h"
+
+#include <tuple>
+#include <utility>
+
+namespace celerity::algorithm
+{
+	// Record type stored as one buffer per field (structure of arrays), so that
+	// kernels only transfer and stream the fields they access.
+	template<size_t Rank, typename...Fields>
+	class basic_soa_buffer
+	{
+	public:
+		static_assert(sizeof...(Fields) > 0, "soa buffers need at least one field");
+
+		explicit basic_soa_buffer(cl::sycl::range<Rank> r)
+			: fields_(celerity::buffer<Fields, Rank>{ r }...)
+		{
+		}
+
+		template<size_t I>
+		auto& field() { return std::get<I>(fields_); }
+
+		cl::sycl::range<Rank> get_range() const { return std::get<0>(fields_).get_range(); }
+
+	private:
+		std::tuple<celerity::buffer<Fields, Rank>...> fields_;
+	};
+
+	template<typename...Fields>
+	using soa_buffer = basic_soa_buffer<1, Fields...>;
+
+	// Iterator over the records of an soa buffer, or a selection of its fields.
+	// Moves one iterator per field in lockstep; dereferencing yields the position.
+	template<size_t Rank, typename...Fields>
+	class soa_iterator
+	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = cl::sycl::id<Rank>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = cl::sycl::id<Rank>;
+
+		explicit soa_iterator(iterator<Fields, Rank>...fields) : fields_(std::move(fields)...) {}
+
+		bool operator ==(const soa_iterator& rhs) const { return *(*this) == *rhs; }
+		bool operator !=(const soa_iterator& rhs) const { return !(*this == rhs); }
+
+		soa_iterator& operator+=(difference_type n)
+		{
+			std::apply([n](auto&...fields) { ((fields += n), ...); }, fields_);
+			return *this;
+		}
+
+		soa_iterator& operator-=(difference_type n) { return *this += -n; }
+		soa_iterator& operator++() { return *this += 1; }
+		soa_iterator& operator--() { return *this -= 1; }
+		soa_iterator operator++(int) { auto it = *this; ++*this; return it; }
+		soa_iterator operator--(int) { auto it = *this; --*this; return it; }
+
+		soa_iterator operator+(difference_type n) const { return soa_iterator{ *this } += n; }
+		soa_iterator operator-(difference_type n) const { return soa_iterator{ *this } -= n; }
+		friend soa_iterator operator+(difference_type n, const soa_iterator& it) { return it + n; }
+
+		difference_type operator-(const soa_iterator& rhs) const { return std::get<0>(fields_) - std::get<0>(rhs.fields_); }
+
+		bool operator <(const soa_iterator& rhs) const { return *this - rhs < 0; }
+		bool operator >(const soa_iterator& rhs) const { return rhs < *this; }
+		bool operator <=(const soa_iterator& rhs) const { return !(rhs < *this); }
+		bool operator >=(const soa_iterator& rhs) const { return !(*this < rhs); }
+
+		[[nodiscard]] cl::sycl::id<Rank> operator*() const { return *std::get<0>(fields_); }
+		[[nodiscard]] cl::sycl::id<Rank> operator[](difference_type n) const { return *(*this + n); }
+
+		template<size_t I>
+		auto field() const { return std::get<I>(fields_); }
+
+		const std::tuple<iterator<Fields, Rank>...>& fields() const { return fields_; }
+
+	private:
+		std::tuple<iterator<Fields, Rank>...> fields_;
+	};
+
+	namespace detail
+	{
+		template<size_t Rank, typename...Fields, size_t...Is>
+		auto fields_of(basic_soa_buffer<Rank, Fields...>& buffer, std::index_sequence<Is...>)
+		{
+			return std::tie(buffer.template field<Is>()...);
+		}
+	}
+
+	template<size_t Rank, typename...Fields>
+	soa_iterator<Rank, Fields...> begin(basic_soa_buffer<Rank, Fields...>& buffer)
+	{
+		return std::apply([](auto&...fields) { return soa_iterator<Rank, Fields...>{ celerity::begin(fields)... }; }, detail::fields_of(buffer, std::index_sequence_for<Fields...>{}));
+	}
+
+	template<size_t Rank, typename...Fields>
+	soa_iterator<Rank, Fields...> end(basic_soa_buffer<Rank, Fields...>& buffer)
+	{
+		return std::apply([](auto&...fields) { return soa_iterator<Rank, Fields...>{ celerity::end(fields)... }; }, detail::fields_of(buffer, std::index_sequence_for<Fields...>{}));
+	}
+
+	// iterator over field I, usable with every algorithm
+	template<size_t I, size_t Rank, typename...Fields>
+	auto field(const soa_iterator<Rank, Fields...>& it)
+	{
+		return it.template field<I>();
+	}
+
+	// iterator over the fields Is only; kernels on it access no other field
+	template<size_t...Is, size_t Rank, typename...Fields>
+	auto select(const soa_iterator<Rank, Fields...>& it)
+	{
+		return soa_iterator<Rank, std::tuple_element_t<Is, std::tuple<Fields...>>...>{ it.template field<Is>()... };
+	}
+
+	namespace detail
+	{
+		template<size_t Rank, typename...Fields>
+		cl::sycl::range<Rank> distance(const soa_iterator<Rank, Fields...>& beg, const soa_iterator<Rank, Fields...>& end)
+		{
+			return distance(beg.template field<0>(), end.template field<0>());
+		}
+
+		template<typename ExecutionPolicy, celerity::access_mode Mode, size_t Rank, typename...Fields>
+		auto get_field_access(celerity::handler cgh, const soa_iterator<Rank, Fields...>& beg, cl::sycl::range<Rank> r)
+		{
+			return std::apply([&](const auto&...fields)
+				{
+					return std::make_tuple(get_access<ExecutionPolicy, Mode, access_type::one_to_one>(cgh, fields, r)...);
+				}, beg.fields());
+		}
+	}
+
+	namespace actions
+	{
+		namespace detail
+		{
+			// invokes f with a reference to every field of the record
+			template<typename ExecutionPolicy, typename F, size_t Rank, typename...Fields>
+			auto soa_for_each(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, const F& f)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				const auto r = algorithm::detail::distance(beg, end);
+
+				return [=](celerity::handler cgh)
+				{
+					auto accs = algorithm::detail::get_field_access<execution_policy, celerity::access_mode::read_write>(cgh, beg, r);
+
+					const auto apply = [&](auto item)
+					{
+						std::apply([&](auto&...acc) { f(acc[item]...); }, accs);
+					};
+
+					if constexpr (policy_traits<execution_policy>::is_distributed)
+					{
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(r, [&](auto item)
+							{
+								apply(item);
+							});
+					}
+					else
+					{
+						cgh.run([&]()
+							{
+								algorithm::detail::for_each_item(r, apply);
+							});
+					}
+				};
+			}
+
+			// invokes f with the input fields and assigns the returned tuple to the output fields
+			template<typename ExecutionPolicy, typename F, size_t Rank, typename...Fields, typename...OutFields>
+			auto soa_transform(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, soa_iterator<Rank, OutFields...> out, const F& f)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				const auto r = algorithm::detail::distance(beg, end);
+				assert(algorithm::detail::fits(out.template field<0>(), r));
+
+				return [=](celerity::handler cgh)
+				{
+					const auto in_accs = algorithm::detail::get_field_access<execution_policy, celerity::access_mode::read>(cgh, beg, r);
+					auto out_accs = algorithm::detail::get_field_access<execution_policy, celerity::access_mode::discard_write>(cgh, out, r);
+
+					const auto apply = [&](auto item)
+					{
+						const std::tuple<OutFields...> result = std::apply([&](const auto&...acc) { return f(acc[item]...); }, in_accs);
+						std::apply([&](auto&...acc) { std::tie(acc[item]...) = result; }, out_accs);
+					};
+
+					if constexpr (policy_traits<execution_policy>::is_distributed)
+					{
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(r, [&](auto item)
+							{
+								apply(item);
+							});
+					}
+					else
+					{
+						cgh.run([&]()
+							{
+								algorithm::detail::for_each_item(r, apply);
+							});
+					}
+				};
+			}
+		}
+
+		template<typename ExecutionPolicy, size_t Rank, typename...Fields, typename F>
+		auto for_each(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, const F& f)
+		{
+			return task(p, detail::soa_for_each(p, beg, end, f));
+		}
+
+		// f returns one value per output field as a tuple
+		template<typename ExecutionPolicy, size_t Rank, typename...Fields, typename...OutFields, typename F>
+		auto transform(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, soa_iterator<Rank, OutFields...> out, const F& f)
+		{
+			return task(p, detail::soa_transform(p, beg, end, out, f));
+		}
+
+		template<typename ExecutionPolicy, size_t Rank, typename...Fields, typename U, typename F>
+		auto transform(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, iterator<U, Rank> out, const F& f)
+		{
+			return std::apply([&](const auto&...fields)
+				{
+					return task(p, detail::zip_transform(p, out, algorithm::detail::distance(beg, end), f, fields...));
+				}, beg.fields());
+		}
+	}
+
+	template<typename ExecutionPolicy, size_t Rank, typename...Fields, typename F>
+	void for_each(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, const F& f)
+	{
+		actions::for_each(p, beg, end, f) | submit_to(p.q);
+	}
+
+	template<typename ExecutionPolicy, size_t Rank, typename...Fields, typename Out, typename F>
+	void transform(ExecutionPolicy p, soa_iterator<Rank, Fields...> beg, soa_iterator<Rank, Fields...> end, Out out, const F& f)
+	{
+		actions::transform(p, beg, end, out, f) | submit_to(p.q);
+	}
+}
+
+#endif // SOA_H
@@ -0,0 +1,377 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include "algorithm.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace celerity::algorithm
+{
+	namespace detail
+	{
+		template<typename KernelName> class sort_local_kernel;
+		template<typename KernelName> class sort_sample_kernel;
+		template<typename KernelName> class sort_count_kernel;
+		template<typename KernelName> class sort_merge_kernel;
+		template<typename KernelName> class sort_pack_kernel;
+		template<typename KernelName> class sort_unpack_kernel;
+		template<typename KernelName> class sort_by_key_kernel;
+
+		// Maps a range of buckets to the elements they occupy in a run of buckets, which is either
+		// the output the buckets are merged into or the locally sorted run of one chunk
+		struct bucket_range_mapper
+		{
+			int offset;
+			std::vector<int> bucket_offsets;
+
+			subrange<1> operator()(celerity::chunk<1> chnk) const
+			{
+				const auto first = bucket_offsets[chnk.offset[0]];
+				const auto last = bucket_offsets[chnk.offset[0] + chnk.range[0]];
+
+				return { { offset + first }, { last - first } };
+			}
+		};
+
+		template<bool Stable, typename RandomIt, typename Compare>
+		void local_sort(RandomIt beg, RandomIt end, const Compare& comp)
+		{
+			if constexpr (Stable)
+			{
+				std::stable_sort(beg, end, comp);
+			}
+			else
+			{
+				std::sort(beg, end, comp);
+			}
+		}
+
+		// Where the buckets are found in the sorted runs and in the output
+		struct bucket_layout
+		{
+			std::vector<int> output;            // first output element per bucket, plus the total
+			std::vector<std::vector<int>> runs; // per chunk: first element per bucket within its run, plus the run length
+		};
+
+		// Distributed sample sort:
+		//   1. every chunk is sorted locally into a temporary buffer
+		//   2. every chunk draws regularly spaced samples from its sorted run
+		//   3. the master sorts the samples and selects one splitter per bucket boundary
+		//   4. every chunk counts its elements per bucket
+		//   5. the master turns the counts into the bucket layout for the range mappers of step 6
+		//   6. every bucket gathers its runs from all chunks and merges them into the output
+		// Only the samples and the counts are transferred to the master. In step 6 every bucket
+		// requests only its own run of each chunk, so the exchange is all-to-all: every element
+		// is moved once, to the bucket it belongs to.
+		template<bool Stable, typename ExecutionPolicy, typename T, typename Compare>
+		void sort(ExecutionPolicy p, iterator<T, 1> beg, iterator<T, 1> end, const Compare& comp, cl::sycl::range<1> chunk_size)
+		{
+			using execution_policy = std::decay_t<ExecutionPolicy>;
+
+			const auto r = algorithm::detail::distance(beg, end);
+			const auto n = r[0];
+
+			if (n == 0) return;
+
+			const auto chunks = algorithm::detail::chunk_count(r, chunk_size)[0];
+
+			if constexpr (!policy_traits<execution_policy>::is_distributed)
+			{
+				actions::for_each(p, beg, end, [comp](chunk<T, 1> chnk) { local_sort<Stable>(chnk.begin(), chnk.end(), comp); }, r) | submit_to(p.q);
+			}
+			else
+			{
+				using kernel_name = typename policy_traits<execution_policy>::kernel_name;
+
+				if (chunks == 1)
+				{
+					task<blocking_master_execution_policy>([=](celerity::handler cgh)
+					{
+						auto acc = get_raw_access<access_mode::read_write>(cgh, beg.buffer(), r, *beg);
+
+						cgh.run([&]()
+						{
+							const auto data = acc.get_pointer() + (*beg)[0];
+							local_sort<Stable>(data, data + n, comp);
+						});
+					}) | submit_to(p.q);
+
+					return;
+				}
+
+				const auto samples_per_chunk = chunks - 1;
+				const auto buckets = chunks;
+
+				// pending tasks hold copies of the buffers, the leases only have to outlive the submissions
+				const auto sorted_scratch = algorithm::detail::scratch<T>(r);
+				const auto samples_scratch = algorithm::detail::scratch<T>(cl::sycl::range<1>{ chunks * samples_per_chunk });
+				const auto splitters_scratch = algorithm::detail::scratch<T>(cl::sycl::range<1>{ buckets - 1 });
+				const auto counts_scratch = algorithm::detail::scratch<int>(cl::sycl::range<1>{ chunks * buckets });
+
+				auto sorted = *sorted_scratch;
+				auto samples = *samples_scratch;
+				auto splitters = *splitters_scratch;
+				auto counts = *counts_scratch;
+
+				const auto sorted_beg = celerity::begin(sorted), sorted_end = celerity::end(sorted);
+				const auto samples_beg = celerity::begin(samples), samples_end = celerity::end(samples);
+				const auto counts_beg = celerity::begin(counts), counts_end = celerity::end(counts);
+
+				// 1. local sort
+
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto in_acc = get_access<execution_policy, access_mode::read, access_type::chunk>(cgh, beg, end, chunk_size);
+					auto out_acc = get_access<execution_policy, access_mode::discard_write, access_type::chunk>(cgh, sorted_beg, sorted_end, chunk_size);
+
+					cgh.parallel_for<sort_local_kernel<kernel_name>>(cl::sycl::range<1>{ chunks }, [&](auto item)
+					{
+						const auto in = in_acc[item];
+						const auto out = out_acc[item];
+
+						std::copy(in.begin(), in.end(), out.begin());
+						local_sort<Stable>(out.begin(), out.end(), comp);
+					});
+				}) | submit_to(p.q);
+
+				// 2. sampling
+
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto in_acc = get_access<execution_policy, access_mode::read, access_type::chunk>(cgh, sorted_beg, sorted_end, chunk_size);
+					auto out_acc = get_access<execution_policy, access_mode::discard_write, access_type::chunk>(cgh, samples_beg, samples_end, cl::sycl::range<1>{ samples_per_chunk });
+
+					cgh.parallel_for<sort_sample_kernel<kernel_name>>(cl::sycl::range<1>{ chunks }, [&](auto item)
+					{
+						const auto run = in_acc[item];
+						const auto out = out_acc[item];
+
+						for (auto j = 0; j < samples_per_chunk; ++j)
+						{
+							out.begin()[j] = run.begin()[((j + 1) * run.size()) / (samples_per_chunk + 1)];
+						}
+					});
+				}) | submit_to(p.q);
+
+				// 3. splitter selection
+
+				task<blocking_master_execution_policy>([=](celerity::handler cgh)
+				{
+					auto samples_acc = get_raw_access<access_mode::read>(cgh, samples, samples.get_range());
+					auto splitters_acc = get_raw_access<access_mode::discard_write>(cgh, splitters, splitters.get_range());
+
+					cgh.run([&]()
+					{
+						const auto m = samples.get_range()[0];
+
+						std::vector<T> sorted_samples(samples_acc.get_pointer(), samples_acc.get_pointer() + m);
+						std::sort(sorted_samples.begin(), sorted_samples.end(), comp);
+
+						for (auto k = 0; k < buckets - 1; ++k)
+						{
+							splitters_acc.get_pointer()[k] = sorted_samples[std::min(m - 1, ((k + 1) * m) / buckets)];
+						}
+					});
+				}) | submit_to(p.q);
+
+				// 4. bucket counts
+
+				task(p, [=](celerity::handler cgh)
+				{
+					const auto in_acc = get_access<execution_policy, access_mode::read, access_type::chunk>(cgh, sorted_beg, sorted_end, chunk_size);
+					const auto splitters_acc = get_raw_access<access_mode::read>(cgh, splitters, celerity::access::fixed<1>({ { 0 }, splitters.get_range() }), splitters.get_range());
+					auto counts_acc = get_access<execution_policy, access_mode::discard_write, access_type::chunk>(cgh, counts_beg, counts_end, cl::sycl::range<1>{ buckets });
+
+					cgh.parallel_for<sort_count_kernel<kernel_name>>(cl::sycl::range<1>{ chunks }, [&](auto item)
+					{
+						const auto run = in_acc[item];
+						const auto out = counts_acc[item];
+						const auto splitter = splitters_acc.get_pointer();
+
+						auto first = run.begin();
+
+						for (auto b = 0; b < buckets - 1; ++b)
+						{
+							const auto last = std::lower_bound(first, run.end(), splitter[b], comp);
+							out.begin()[b] = static_cast<int>(last - first);
+							first = last;
+						}
+
+						out.begin()[buckets - 1] = static_cast<int>(run.end() - first);
+					});
+				}) | submit_to(p.q);
+
+				// 5. bucket layout
+
+				const auto layout = task<blocking_master_execution_policy>([=](celerity::handler cgh)
+				{
+					auto counts_acc = get_raw_access<access_mode::read>(cgh, counts, counts.get_range());
+
+					bucket_layout l{ std::vector<int>(buckets + 1, 0), std::vector<std::vector<int>>(chunks, std::vector<int>(buckets + 1, 0)) };
+
+					cgh.run([&]()
+					{
+						const auto count = counts_acc.get_pointer();
+
+						for (auto b = 0; b < buckets; ++b)
+						{
+							l.output[b + 1] = l.output[b];
+
+							for (auto i = 0; i < chunks; ++i)
+							{
+								l.output[b + 1] += count[i * buckets + b];
+								l.runs[i][b + 1] = l.runs[i][b] + count[i * buckets + b];
+							}
+						}
+					});
+
+					return l;
+				}) | submit_to(p.q);
+
+				// 6. redistribution and merge
+
+				task(p, [=](celerity::handler cgh)
+				{
+					// one accessor per chunk: bucket b reads elements [runs[i][b], runs[i][b + 1]) of run i
+					std::vector<celerity::accessor<access_mode::read, T, 1>> in_accs;
+					in_accs.reserve(chunks);
+
+					for (auto i = 0; i < chunks; ++i)
+					{
+						in_accs.push_back(get_raw_access<access_mode::read>(cgh, sorted, bucket_range_mapper{ i * chunk_size[0], layout.runs[i] }, cl::sycl::range<1>{ layout.runs[i][buckets] }));
+					}
+
+					auto out_acc = get_raw_access<access_mode::discard_write>(cgh, beg.buffer(), bucket_range_mapper{ (*beg)[0], layout.output }, r);
+
+					cgh.parallel_for<sort_merge_kernel<kernel_name>>(cl::sycl::range<1>{ buckets }, [&](auto item)
+					{
+						const auto b = item[0];
+						const auto out = out_acc.get_pointer() + (*beg)[0] + layout.output[b];
+
+						auto merged = 0;
+
+						for (auto i = 0; i < chunks; ++i)
+						{
+							const auto run = in_accs[i].get_pointer() + i * chunk_size[0] + layout.runs[i][b];
+							const auto len = layout.runs[i][b + 1] - layout.runs[i][b];
+
+							std::copy(run, run + len, out + merged);
+							std::inplace_merge(out, out + merged, out + merged + len, comp);
+
+							merged += len;
+						}
+					});
+				}) | submit_to(p.q);
+			}
+		}
+
+		template<typename ExecutionPolicy, typename K, typename V, typename Compare>
+		void sort_by_key(ExecutionPolicy p, iterator<K, 1> keys_beg, iterator<K, 1> keys_end, iterator<V, 1> values_beg, const Compare& comp, cl::sycl::range<1> chunk_size)
+		{
+			using execution_policy = std::decay_t<ExecutionPolicy>;
+			using pair_type = std::pair<K, V>;
+
+			const auto r = algorithm::detail::distance(keys_beg, keys_end);
+			assert(algorithm::detail::fits(values_beg, r));
+
+			const auto pairs_scratch = algorithm::detail::scratch<pair_type>(r);
+			auto pairs = *pairs_scratch;
+			const auto pairs_beg = celerity::begin(pairs), pairs_end = celerity::end(pairs);
+
+			const auto pair_comp = [comp](const pair_type& lhs, const pair_type& rhs) { return comp(lhs.first, rhs.first); };
+
+			task(p, [=](celerity::handler cgh)
+			{
+				const auto keys_acc = get_access<execution_policy, access_mode::read, access_type::one_to_one>(cgh, keys_beg, r);
+				const auto values_acc = get_access<execution_policy, access_mode::read, access_type::one_to_one>(cgh, values_beg, r);
+				auto pairs_acc = get_access<execution_policy, access_mode::discard_write, access_type::one_to_one>(cgh, pairs_beg, r);
+
+				const auto pack = [&](auto item)
+				{
+					pairs_acc[item] = pair_type{ keys_acc[item], values_acc[item] };
+				};
+
+				if constexpr (policy_traits<execution_policy>::is_distributed)
+				{
+					cgh.parallel_for<sort_pack_kernel<typename policy_traits<execution_policy>::kernel_name>>(r, pack);
+				}
+				else
+				{
+					cgh.run([&]() { algorithm::detail::for_each_item(r, pack); });
+				}
+			}) | submit_to(p.q);
+
+			if constexpr (policy_traits<execution_policy>::is_distributed)
+			{
+				using kernel_name = typename policy_traits<execution_policy>::kernel_name;
+
+				sort<true>(distr<sort_by_key_kernel<kernel_name>>(p.q, p.split), pairs_beg, pairs_end, pair_comp, chunk_size);
+			}
+			else
+			{
+				sort<true>(p, pairs_beg, pairs_end, pair_comp, chunk_size);
+			}
+
+			task(p, [=](celerity::handler cgh)
+			{
+				const auto pairs_acc = get_access<execution_policy, access_mode::read, access_type::one_to_one>(cgh, pairs_beg, r);
+				auto keys_acc = get_access<execution_policy, access_mode::discard_write, access_type::one_to_one>(cgh, keys_beg, r);
+				auto values_acc = get_access<execution_policy, access_mode::discard_write, access_type::one_to_one>(cgh, values_beg, r);
+
+				const auto unpack = [&](auto item)
+				{
+					const pair_type pair = pairs_acc[item];
+					keys_acc[item] = pair.first;
+					values_acc[item] = pair.second;
+				};
+
+				if constexpr (policy_traits<execution_policy>::is_distributed)
+				{
+					cgh.parallel_for<sort_unpack_kernel<typename policy_traits<execution_policy>::kernel_name>>(r, unpack);
+				}
+				else
+				{
+					cgh.run([&]() { algorithm::detail::for_each_item(r, unpack); });
+				}
+			}) | submit_to(p.q);
+		}
+	}
+
+	template<typename ExecutionPolicy, typename T, size_t Rank, typename Compare = std::less<T>>
+	void sort(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const Compare& comp = {})
+	{
+		static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+
+		detail::sort<false>(p, beg, end, comp, detail::default_chunk_size(detail::distance(beg, end)));
+	}
+
+	template<typename ExecutionPolicy, typename T, size_t Rank, typename Compare>
+	void sort(ExecutionPolicy p, iterator<T, Rank> beg, iterator<T, Rank> end, const Compare& comp, cl::sycl::range<Rank> chunk_size)
+	{
+		static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+
+		detail::sort<false>(p, beg, end, comp, chunk_size);
+	}
+
+	// stable: values of equal keys keep their relative order
+	template<typename ExecutionPolicy, typename K, typename V, size_t Rank, typename Compare = std::less<K>>
+	void sort_by_key(ExecutionPolicy p, iterator<K, Rank> keys_beg, iterator<K, Rank> keys_end, iterator<V, Rank> values_beg, const Compare& comp = {})
+	{
+		static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+
+		detail::sort_by_key(p, keys_beg, keys_end, values_beg, comp, detail::default_chunk_size(detail::distance(keys_beg, keys_end)));
+	}
+
+	template<typename ExecutionPolicy, typename K, typename V, size_t Rank, typename Compare>
+	void sort_by_key(ExecutionPolicy p, iterator<K, Rank> keys_beg, iterator<K, Rank> keys_end, iterator<V, Rank> values_beg, const Compare& comp, cl::sycl::range<Rank> chunk_size)
+	{
+		static_assert(Rank == 1, "Only 1-dimenionsal buffers for now");
+
+		detail::sort_by_key(p, keys_beg, keys_end, values_beg, comp, chunk_size);
+	}
+}
+
+#endif // SORT_H
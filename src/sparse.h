@@ -0,0 +1,227 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "algorithm.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace celerity::algorithm
+{
+	namespace detail
+	{
+		// Host copy of the sparsity pattern. Range mappers use it to find the entries of a
+		// block of rows and the columns of x those rows read.
+		struct csr_structure
+		{
+			int rows;
+			int cols;
+			std::vector<int> row_ptr;
+			std::vector<int> first_col; // smallest column per row, cols for empty rows
+			std::vector<int> last_col;  // one past the largest column per row, 0 for empty rows
+
+			// rows of the chunk within the matrix; accesses outside of kernels are resolved with the buffer range
+			std::pair<int, int> rows_of(const celerity::chunk<1>& chnk) const
+			{
+				const auto first = std::min(chnk.offset[0], rows);
+				return { first, std::min(chnk.offset[0] + chnk.range[0], rows) };
+			}
+
+			subrange<1> entries(const celerity::chunk<1>& chnk) const
+			{
+				const auto [first, last] = rows_of(chnk);
+				return { { row_ptr[first] }, { row_ptr[last] - row_ptr[first] } };
+			}
+
+			// smallest interval covering all columns read by the rows of the chunk
+			subrange<1> columns(const celerity::chunk<1>& chnk, int offset) const
+			{
+				const auto [first, last] = rows_of(chnk);
+
+				auto lo = cols, hi = 0;
+				for (auto row = first; row < last; ++row)
+				{
+					lo = std::min(lo, first_col[row]);
+					hi = std::max(hi, last_col[row]);
+				}
+
+				if (lo >= hi) return { { offset }, { 0 } };
+
+				return { { offset + lo }, { hi - lo } };
+			}
+		};
+
+		// the row pointers of a block of rows and of the row following it
+		struct csr_row_ptr_range_mapper
+		{
+			std::shared_ptr<const csr_structure> structure;
+
+			subrange<1> operator()(celerity::chunk<1> chnk) const
+			{
+				const auto [first, last] = structure->rows_of(chnk);
+				return { { first }, { last - first + 1 } };
+			}
+		};
+
+		struct csr_entries_range_mapper
+		{
+			std::shared_ptr<const csr_structure> structure;
+
+			subrange<1> operator()(celerity::chunk<1> chnk) const { return structure->entries(chnk); }
+		};
+
+		struct csr_columns_range_mapper
+		{
+			std::shared_ptr<const csr_structure> structure;
+			int offset;
+
+			subrange<1> operator()(celerity::chunk<1> chnk) const { return structure->columns(chnk, offset); }
+		};
+	}
+
+	// Sparse matrix in compressed sparse row format: the entries of row i are
+	// values[row_ptr[i]..row_ptr[i + 1]) in the columns col_idx[row_ptr[i]..row_ptr[i + 1]).
+	// The pattern is fixed at construction, values can be updated through values().
+	template<typename T>
+	class csr_matrix
+	{
+	public:
+		csr_matrix(int rows, int cols, const std::vector<int>& row_ptr, const std::vector<int>& col_idx, const std::vector<T>& values)
+			: structure_(make_structure(rows, cols, row_ptr, col_idx, values.size())),
+			  row_ptr_(row_ptr.data(), cl::sycl::range<1>{ rows + 1 }),
+			  col_idx_(col_idx.data(), cl::sycl::range<1>{ nonzeros() }),
+			  values_(values.data(), cl::sycl::range<1>{ nonzeros() })
+		{
+		}
+
+		int rows() const { return structure_->rows; }
+		int cols() const { return structure_->cols; }
+		int nonzeros() const { return structure_->row_ptr.back(); }
+
+		celerity::buffer<int, 1> row_ptr() const { return row_ptr_; }
+		celerity::buffer<int, 1> col_idx() const { return col_idx_; }
+		celerity::buffer<T, 1> values() const { return values_; }
+
+		const std::shared_ptr<const detail::csr_structure>& structure() const { return structure_; }
+
+	private:
+		std::shared_ptr<const detail::csr_structure> structure_;
+		celerity::buffer<int, 1> row_ptr_;
+		celerity::buffer<int, 1> col_idx_;
+		celerity::buffer<T, 1> values_;
+
+		static std::shared_ptr<const detail::csr_structure> make_structure(int rows, int cols, const std::vector<int>& row_ptr, const std::vector<int>& col_idx, size_t nonzeros)
+		{
+			if (rows < 0 || cols < 0) throw std::invalid_argument("csr_matrix: negative extent");
+			if (row_ptr.size() != static_cast<size_t>(rows) + 1 || row_ptr.front() != 0) throw std::invalid_argument("csr_matrix: row_ptr needs rows + 1 entries starting at 0");
+			if (!std::is_sorted(row_ptr.begin(), row_ptr.end())) throw std::invalid_argument("csr_matrix: row_ptr has to be non-decreasing");
+			if (static_cast<size_t>(row_ptr.back()) != col_idx.size() || col_idx.size() != nonzeros) throw std::invalid_argument("csr_matrix: row_ptr, col_idx and values disagree on the number of entries");
+
+			auto s = std::make_shared<detail::csr_structure>();
+			s->rows = rows;
+			s->cols = cols;
+			s->row_ptr = row_ptr;
+			s->first_col.assign(rows, cols);
+			s->last_col.assign(rows, 0);
+
+			for (auto row = 0; row < rows; ++row)
+			{
+				for (auto k = row_ptr[row]; k < row_ptr[row + 1]; ++k)
+				{
+					const auto col = col_idx[k];
+					if (col < 0 || col >= cols) throw std::invalid_argument("csr_matrix: column index out of range");
+
+					s->first_col[row] = std::min(s->first_col[row], col);
+					s->last_col[row] = std::max(s->last_col[row], col + 1);
+				}
+			}
+
+			return s;
+		}
+	};
+
+	namespace actions
+	{
+		namespace detail
+		{
+			// y = a x, distributed by rows. Every chunk of rows reads its own entries and only the
+			// interval of x spanned by their columns.
+			template<typename ExecutionPolicy, typename T>
+			auto spmv(ExecutionPolicy p, const csr_matrix<T>& a, iterator<T, 1> x_beg, iterator<T, 1> x_end, iterator<T, 1> y_beg)
+			{
+				using execution_policy = std::decay_t<ExecutionPolicy>;
+
+				const cl::sycl::range<1> rows{ a.rows() };
+
+				assert(algorithm::detail::distance(x_beg, x_end)[0] == a.cols());
+				assert(algorithm::detail::fits(y_beg, rows));
+
+				return [=](celerity::handler cgh)
+				{
+					const auto nonzeros = cl::sycl::range<1>{ a.nonzeros() };
+					const auto x_offset = (*x_beg)[0];
+
+					const auto dot = [x_offset](const int* row_ptr, const int* col_idx, const T* values, const T* x, int row)
+					{
+						auto sum = T{};
+						for (auto k = row_ptr[row]; k < row_ptr[row + 1]; ++k)
+						{
+							sum += values[k] * x[x_offset + col_idx[k]];
+						}
+						return sum;
+					};
+
+					if constexpr (policy_traits<execution_policy>::is_distributed)
+					{
+						const auto& s = a.structure();
+
+						const auto row_ptr_acc = get_raw_access<access_mode::read>(cgh, a.row_ptr(), algorithm::detail::csr_row_ptr_range_mapper{ s }, a.row_ptr().get_range());
+						const auto col_idx_acc = get_raw_access<access_mode::read>(cgh, a.col_idx(), algorithm::detail::csr_entries_range_mapper{ s }, nonzeros);
+						const auto values_acc = get_raw_access<access_mode::read>(cgh, a.values(), algorithm::detail::csr_entries_range_mapper{ s }, nonzeros);
+						const auto x_acc = get_raw_access<access_mode::read>(cgh, x_beg.buffer(), algorithm::detail::csr_columns_range_mapper{ s, x_offset }, algorithm::detail::distance(x_beg, x_end));
+						auto y_acc = get_access<execution_policy, access_mode::discard_write, access_type::one_to_one>(cgh, y_beg, rows);
+
+						cgh.parallel_for<typename policy_traits<execution_policy>::kernel_name>(rows, [&](auto item)
+							{
+								y_acc[item] = dot(row_ptr_acc.get_pointer(), col_idx_acc.get_pointer(), values_acc.get_pointer(), x_acc.get_pointer(), item[0]);
+							});
+					}
+					else
+					{
+						const auto row_ptr_acc = get_raw_access<access_mode::read>(cgh, a.row_ptr(), a.row_ptr().get_range());
+						const auto col_idx_acc = get_raw_access<access_mode::read>(cgh, a.col_idx(), nonzeros);
+						const auto values_acc = get_raw_access<access_mode::read>(cgh, a.values(), nonzeros);
+						const auto x_acc = get_raw_access<access_mode::read>(cgh, x_beg.buffer(), algorithm::detail::distance(x_beg, x_end), *x_beg);
+						auto y_acc = get_access<execution_policy, access_mode::discard_write, access_type::one_to_one>(cgh, y_beg, rows);
+
+						cgh.run([&]()
+							{
+								algorithm::detail::for_each_item(rows, [&](auto item)
+									{
+										y_acc[item] = dot(row_ptr_acc.get_pointer(), col_idx_acc.get_pointer(), values_acc.get_pointer(), x_acc.get_pointer(), item[0]);
+									});
+							});
+					}
+				};
+			}
+		}
+
+		template<typename ExecutionPolicy, typename T>
+		auto spmv(ExecutionPolicy p, const csr_matrix<T>& a, iterator<T, 1> x_beg, iterator<T, 1> x_end, iterator<T, 1> y_beg)
+		{
+			return task(p, detail::spmv(p, a, x_beg, x_end, y_beg));
+		}
+	}
+
+	// y = a x for x in [x_beg, x_end) with a.cols() elements and a.rows() elements at y_beg
+	template<typename ExecutionPolicy, typename T>
+	void spmv(ExecutionPolicy p, const csr_matrix<T>& a, iterator<T, 1> x_beg, iterator<T, 1> x_end, iterator<T, 1> y_beg)
+	{
+		actions::spmv(p, a, x_beg, x_end, y_beg) | submit_to(p.q);
+	}
+}
+
+#endif // SPARSE_H
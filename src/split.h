@@ -0,0 +1,224 @@
+#ifndef SPLIT_H
+#define SPLIT_H
+
+#include "celerity.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace celerity::algorithm
+{
+	// identifies the kernel name of a task; kernel names are usually incomplete types, which only typeid of a pointer accepts
+	using kernel_id = std::type_index;
+
+	template<typename KernelName>
+	kernel_id kernel_id_of() { return typeid(KernelName*); }
+
+	// Decides which share of a kernel's first dimension each node executes.
+	// Weights have to be identical on all nodes, observe is called with the
+	// same arguments on all nodes, so stateful strategies stay in sync.
+	// Both receive the kernel name of the task: what a strategy learns about
+	// a kernel belongs to the kernel, not to the policy holding the strategy.
+	class split_strategy
+	{
+	public:
+		virtual ~split_strategy() = default;
+
+		// relative share of each of the given number of nodes, empty for an even split
+		virtual std::vector<double> weights(kernel_id kernel, int nodes) const = 0;
+
+		// nodes per dimension of the kernel range, nodes are split along the first dimension by default
+		virtual std::array<int, 3> grid(int nodes, const std::array<int, 3>& global_size) const { return { nodes, 1, 1 }; }
+
+		// items and execution time in seconds of every node for the last run of the kernel
+		virtual void observe(kernel_id kernel, const std::vector<int>& items, const std::vector<double>& seconds) {}
+	};
+
+	class even_split : public split_strategy
+	{
+	public:
+		std::vector<double> weights(kernel_id, int) const override { return {}; }
+	};
+
+	// fixed user-provided weights, nodes without a weight get 1
+	class weighted_split : public split_strategy
+	{
+	public:
+		explicit weighted_split(std::vector<double> weights) : weights_(std::move(weights))
+		{
+			assert(std::all_of(weights_.begin(), weights_.end(), [](double w) { return w >= 0; }));
+		}
+
+		std::vector<double> weights(kernel_id, int nodes) const override
+		{
+			auto w = weights_;
+			w.resize(nodes, 1.0);
+			return w;
+		}
+
+	private:
+		std::vector<double> weights_;
+	};
+
+	// Weights nodes by their observed throughput (items per second), smoothed
+	// over subsequent submissions. Starts with an even split. Throughput is kept
+	// per kernel name and shared by all instances, so policies created anew for
+	// every submission of a kernel still rebalance it.
+	class throughput_split : public split_strategy
+	{
+	public:
+		explicit throughput_split(double smoothing = 0.5) : smoothing_(smoothing)
+		{
+			assert(smoothing >= 0 && smoothing < 1);
+		}
+
+		std::vector<double> weights(kernel_id kernel, int nodes) const override
+		{
+			std::lock_guard<std::mutex> lock{ mutex() };
+
+			const auto it = throughput().find(kernel);
+			if (it == throughput().end()) return {};
+
+			// an even split until every node has been measured
+			const auto& t = it->second;
+			if (static_cast<int>(t.size()) != nodes) return {};
+			if (std::find(t.begin(), t.end(), 0.0) != t.end()) return {};
+
+			return t;
+		}
+
+		void observe(kernel_id kernel, const std::vector<int>& items, const std::vector<double>& seconds) override
+		{
+			std::lock_guard<std::mutex> lock{ mutex() };
+
+			auto& t = throughput()[kernel];
+
+			if (t.size() != items.size())
+			{
+				t.assign(items.size(), 0.0);
+			}
+
+			for (size_t i = 0; i < items.size(); ++i)
+			{
+				// nodes without work or measurable time keep their estimate
+				if (items[i] == 0 || seconds[i] <= 0) continue;
+
+				const auto observed = items[i] / seconds[i];
+				t[i] = t[i] == 0 ? observed : smoothing_ * t[i] + (1 - smoothing_) * observed;
+			}
+		}
+
+	private:
+		double smoothing_;
+
+		static std::map<kernel_id, std::vector<double>>& throughput()
+		{
+			static std::map<kernel_id, std::vector<double>> t;
+			return t;
+		}
+
+		static std::mutex& mutex()
+		{
+			static std::mutex m;
+			return m;
+		}
+	};
+
+	namespace detail
+	{
+		// Grid of nodes (product equal to nodes) whose blocks of global_size share the least surface,
+		// i.e. the least halo data exchanged by neighbourhood kernels. Ties prefer fewer splits of
+		// the inner dimensions, which keeps blocks contiguous.
+		inline std::array<int, 3> surface_minimising_grid(int nodes, const std::array<int, 3>& global_size)
+		{
+			std::array<int, 3> best{ nodes, 1, 1 };
+			auto best_surface = -1.0;
+
+			for (auto g0 = 1; g0 <= nodes; ++g0)
+			{
+				if (nodes % g0 != 0) continue;
+
+				for (auto g1 = 1; g1 <= nodes / g0; ++g1)
+				{
+					if (nodes / g0 % g1 != 0) continue;
+
+					const std::array<int, 3> grid{ g0, g1, nodes / g0 / g1 };
+
+					auto surface = 0.0;
+					auto valid = true;
+
+					for (size_t d = 0; d < 3; ++d)
+					{
+						valid = valid && grid[d] <= std::max(1, global_size[d]);
+
+						// every cut through dimension d spans the other two dimensions
+						surface += (grid[d] - 1.0) * global_size[(d + 1) % 3] * global_size[(d + 2) % 3];
+					}
+
+					if (!valid) continue;
+
+					if (best_surface < 0 || surface < best_surface || (surface == best_surface && grid[0] > best[0]))
+					{
+						best = grid;
+						best_surface = surface;
+					}
+				}
+			}
+
+			return best;
+		}
+	}
+
+	// Splits N-D kernels into blocks instead of slabs along the first dimension,
+	// choosing the arrangement of nodes that minimises the surface between blocks.
+	class block_split : public split_strategy
+	{
+	public:
+		std::vector<double> weights(kernel_id, int) const override { return {}; }
+
+		std::array<int, 3> grid(int nodes, const std::array<int, 3>& global_size) const override
+		{
+			return detail::surface_minimising_grid(nodes, global_size);
+		}
+	};
+
+	namespace detail
+	{
+		// A strategy in the form the runtime takes it, built once per task so that submissions only
+		// share it. Only the mock runtime (MOCK_CELERITY_MPI) controls the split, the Celerity
+		// runtime keeps its own work assignment.
+#ifdef MOCK_CELERITY
+		using split_handle = std::shared_ptr<const celerity::detail::split_hint>;
+
+		inline split_handle make_split_handle(const std::shared_ptr<split_strategy>& split, kernel_id kernel)
+		{
+			if (!split) return nullptr;
+
+			return std::make_shared<celerity::detail::split_hint>(celerity::detail::split_hint{
+				[split, kernel](int nodes) { return split->weights(kernel, nodes); },
+				[split](int nodes, const std::array<int, 3>& global_size) { return split->grid(nodes, global_size); },
+				[split, kernel](const std::vector<int>& items, const std::vector<double>& seconds) { split->observe(kernel, items, seconds); } });
+		}
+
+		inline void apply_split(celerity::handler& cgh, const split_handle& split)
+		{
+			cgh.split = split;
+		}
+#else
+		using split_handle = std::shared_ptr<split_strategy>;
+
+		inline split_handle make_split_handle(const std::shared_ptr<split_strategy>& split, kernel_id) { return split; }
+
+		inline void apply_split(celerity::handler&, const split_handle&) {}
+#endif
+	}
+}
+
+#endif // SPLIT_H
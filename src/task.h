@@ -2,10 +2,13 @@
 #define TASK_H
 
 #include "celerity.h"
+#include "graph.h"
 #include "kernel_sequence.h"
 #include "policy.h"
+#include "profiler.h"
 
 #include <future>
+#include <memory>
 
 namespace celerity::algorithm
 {
@@ -13,124 +16,117 @@ namespace celerity::algorithm
 template<typename ExecutionPolicy, typename...Actions>
 class task_t;
 
+// Command groups are copied into the queue and may run after operator() returned,
+// so they share ownership of the sequence and the profile. Tasks hold their sequence
+// by shared pointer: copying a task or submitting it never copies its actions.
+
 template<typename...Actions>
 class task_t<distributed_execution_policy, Actions...>
 {
 public:
-	explicit task_t(kernel_sequence<Actions...>&& s)
-		: sequence_(std::move(s)) { }
+	explicit task_t(kernel_sequence<Actions...>&& s, const char* name = "fused")
+		: sequence_(std::make_shared<const kernel_sequence<Actions...>>(std::move(s))), name_(name) { }
 
 	void operator()(distr_queue& q) const
 	{
 		std::cout << "queue.submit([](handler cgh){" << std::endl;
-		q.submit([&](auto cgh) { std::invoke(sequence_, cgh); });
+		detail::submit_task(q, name_, [seq = sequence_](handler cgh) { std::invoke(*seq, cgh); });
 		std::cout << "});" << std::endl << std::endl;
 	}
 
 private:
-	kernel_sequence<Actions...> sequence_;
+	std::shared_ptr<const kernel_sequence<Actions...>> sequence_;
+	const char* name_;
 };
 
 template<typename F>
 class task_t<distributed_execution_policy, F>
 {
 public:
-	task_t(F f) : sequence_(std::move(f)) { }
+	task_t(F f, const char* name = detail::policy_name<distributed_execution_policy>::value, const std::shared_ptr<split_strategy>& split = nullptr,
+		kernel_id kernel = typeid(void))
+		: sequence_(std::make_shared<const kernel_sequence<F>>(std::move(f))), name_(name), split_(detail::make_split_handle(split, kernel)) { }
 
 	decltype(auto) operator()(distr_queue& q) const
 	{
 		std::cout << "queue.submit([](handler cgh){" << std::endl;
-		q.submit([&](auto cgh) { std::invoke(sequence_, cgh); });
+		detail::submit_task(q, name_, [seq = sequence_, split = split_](handler cgh)
+			{
+				detail::apply_split(cgh, split);
+				std::invoke(*seq, cgh);
+			});
 		std::cout << "});" << std::endl << std::endl;
 	}
 
 private:
-	kernel_sequence<F> sequence_;
+	std::shared_ptr<const kernel_sequence<F>> sequence_;
+	const char* name_;
+	detail::split_handle split_;
 };
 
 template<typename F>
 class task_t<non_blocking_master_execution_policy, F>
 {
 public:
-	explicit task_t(F f) : sequence_(std::move(f)) { }
+	explicit task_t(F f, const char* name = detail::policy_name<non_blocking_master_execution_policy>::value)
+		: sequence_(std::make_shared<const kernel_sequence<F>>(std::move(f))), name_(name) { }
 
 	decltype(auto) operator()(distr_queue& q) const
 	{
-		std::cout << "queue.with_master_access([](handler cgh){" << std::endl;
+		detail::ensure_not_recording();
 
-		using ret_type = std::invoke_result_t<decltype(sequence_), handler>;
+		auto profile = task_profile::open(name_, detail::policy_name<non_blocking_master_execution_policy>::value);
 
-		if constexpr (std::is_void_v<ret_type>)
-		{
-			q.with_master_access([&](auto cgh)
-				{
-					std::invoke(sequence_, cgh);
-				});
+		std::cout << "queue.with_master_access([](handler cgh){" << std::endl;
 
-			std::cout << "});" << std::endl << std::endl;
-		}
-		else
-		{
-			std::promise<ret_type> ret_value{};
-			auto future = ret_value.get_future();
+		using ret_type = std::invoke_result_t<const kernel_sequence<F>&, handler&>;
 
-			q.with_master_access([&, promise = std::move(ret_value)](auto cgh) mutable
-				{
-					promise.set_value(std::invoke(sequence_, cgh));
-				});
+		auto future = q.with_master_access([seq = sequence_, profile](handler cgh)
+			{
+				return profiled(profile, [&]() { return std::invoke(*seq, cgh); });
+			});
 
-			std::cout << "});" << std::endl << std::endl;
+		std::cout << "});" << std::endl << std::endl;
 
+		if constexpr (!std::is_void_v<ret_type>)
+		{
 			return future;
 		}
 	}
 
 private:
-	kernel_sequence<F> sequence_;
+	std::shared_ptr<const kernel_sequence<F>> sequence_;
+	const char* name_;
 };
 
 template<typename F>
 class task_t<blocking_master_execution_policy, F>
 {
 public:
-	explicit task_t(F f) : sequence_(std::move(f)) { }
+	explicit task_t(F f, const char* name = detail::policy_name<blocking_master_execution_policy>::value)
+		: sequence_(std::make_shared<const kernel_sequence<F>>(std::move(f))), name_(name) { }
 
 	decltype(auto) operator()(distr_queue& q) const
 	{
-		std::cout << "queue.with_master_access([](handler cgh){" << std::endl;
-
-		using ret_type = std::invoke_result_t<decltype(sequence_), handler>;
-
-		if constexpr (std::is_void_v<ret_type>)
-		{
-			q.with_master_access([&](auto cgh)
-				{
-					std::invoke(sequence_, cgh);
-				});
+		detail::ensure_not_recording();
 
-			q.wait();
+		auto profile = task_profile::open(name_, detail::policy_name<blocking_master_execution_policy>::value);
 
-			std::cout << "});" << std::endl << std::endl;
-		}
-		else
-		{
-			ret_type ret_value{};
+		std::cout << "queue.with_master_access([](handler cgh){" << std::endl;
 
-			q.with_master_access([&](auto cgh) mutable
+		auto future = q.with_master_access([seq = sequence_, profile](handler cgh)
 			{
-				ret_value = std::invoke(sequence_, cgh);
+				return profiled(profile, [&]() { return std::invoke(*seq, cgh); });
 			});
 
-			q.wait();
-
-			std::cout << "});" << std::endl << std::endl;
+		std::cout << "});" << std::endl << std::endl;
 
-			return ret_value;
-		}
+		return future.get();
 	}
 
 private:
-	kernel_sequence<F> sequence_;
+	std::shared_ptr<const kernel_sequence<F>> sequence_;
+	const char* name_;
 };
 
 template<typename KernelName, typename F>
@@ -146,9 +142,9 @@ auto fuse(kernel_sequence<Actions...>&& seq)
 }
 
 template<typename T, typename = std::enable_if_t<is_kernel_v<T>>>
-auto task(const T& invocable)
+auto task(T invocable)
 {
-	return task_t<distributed_execution_policy, T>{ invocable };
+	return task_t<distributed_execution_policy, T>{ std::move(invocable) };
 }
 
 template<typename ExecutionPolicy, typename T>
@@ -158,9 +154,28 @@ auto task(const task_t<ExecutionPolicy, T>& t)
 }
 
 template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_kernel_v<T>>>
-auto task(const T& invocable)
+auto task(T invocable)
+{
+	using execution_policy = std::decay_t<ExecutionPolicy>;
+
+	return task_t<decay_policy_t<ExecutionPolicy>, T>{ std::move(invocable), detail::task_name<execution_policy>::get() };
+}
+
+// like task<ExecutionPolicy>, distributed tasks are split by the strategy of the policy
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_kernel_v<T>>>
+auto task(const ExecutionPolicy& p, T invocable)
 {
-	return task_t<decay_policy_t<ExecutionPolicy>, T>{invocable};
+	using execution_policy = std::decay_t<ExecutionPolicy>;
+
+	if constexpr (policy_traits<execution_policy>::is_distributed)
+	{
+		return task_t<decay_policy_t<ExecutionPolicy>, T>{ std::move(invocable), detail::task_name<execution_policy>::get(), p.split,
+			kernel_id_of<typename policy_traits<execution_policy>::kernel_name>() };
+	}
+	else
+	{
+		return task<ExecutionPolicy>(std::move(invocable));
+	}
 }
 
 template<typename F>
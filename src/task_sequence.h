@@ -29,10 +29,23 @@ namespace celerity::algorithm
 		return std::invoke(lhs, queue);
 	}
 
+	// prepared tasks and sequences are submitted again without copying their actions
+	template<typename ExecutionPolicy, typename T>
+	decltype(auto) operator | (const task_t<ExecutionPolicy, T>& lhs, celerity::distr_queue&& queue)
+	{
+		return std::invoke(lhs, queue);
+	}
+
+	template<typename...Actions>
+	decltype(auto) operator | (const sequence<Actions...>& lhs, celerity::distr_queue&& queue)
+	{
+		return std::invoke(lhs, queue);
+	}
+
 	template<typename ExecutionPolicy, typename...Ts, typename...Us>
 	auto operator | (task_t<ExecutionPolicy, Ts...> lhs, task_t<ExecutionPolicy, Us...> rhs)
 	{
-		return sequence<task_t<ExecutionPolicy, Ts...>, task_t<ExecutionPolicy, Us...>>{lhs, rhs};
+		return sequence<task_t<ExecutionPolicy, Ts...>, task_t<ExecutionPolicy, Us...>>{ std::move(lhs), std::move(rhs) };
 	}
 
 	
@@ -40,98 +53,105 @@ namespace celerity::algorithm
 		std::enable_if_t<is_argless_invokable_v<T>&& is_argless_invokable_v<U>, int> = 0>
 		auto operator | (T lhs, U rhs)
 	{
-		return sequence<T, U>{lhs, rhs};
+		return sequence<T, U>{ std::move(lhs), std::move(rhs) };
 	}
 
 	template<typename T, typename U,
 		std::enable_if_t<is_kernel_v<T> && !is_sequence_v<T>&& is_kernel_v<U>, int> = 0>
 		auto operator | (T lhs, U rhs)
 	{
-		return kernel_sequence<T, U>{ { lhs, rhs }};
+		return kernel_sequence<T, U>{ { std::move(lhs), std::move(rhs) } };
 	}
 
 	template<typename T, typename U,
 		std::enable_if_t<is_kernel_v<T> && !is_sequence_v<T> && !is_kernel_v<U>, int> = 0>
 		auto operator | (T lhs, U rhs)
 	{
-		return sequence<task_t<distributed_execution_policy, T>, U>{ { lhs }, rhs };
+		return sequence<task_t<distributed_execution_policy, T>, U>{ { std::move(lhs) }, std::move(rhs) };
 	}
 
 	template<typename...T, typename U,
 		std::enable_if_t<is_kernel_v<U>, int> = 0>
 		auto operator | (kernel_sequence<T...> lhs, U rhs)
 	{
-		return kernel_sequence<T..., U>{ { lhs.sequence(), rhs } };
+		return kernel_sequence<T..., U>{ { std::move(lhs).sequence(), std::move(rhs) } };
 	}
 
 	template<typename ExecutionPolicy, typename T, typename U,
 		std::enable_if_t<!is_kernel_v<T> && !is_sequence_v<T>&& is_kernel_v<U>, int> = 0>
 		auto operator | (T lhs, U rhs)
 	{
-		return sequence<T, task_t<ExecutionPolicy, U>>{ lhs, { rhs }};
+		return sequence<T, task_t<ExecutionPolicy, U>>{ std::move(lhs), { std::move(rhs) } };
 	}
 
 	template<typename ExecutionPolicy, typename...Ts,typename U, size_t...Ids>
 	auto unpack_kernel_sequence(kernel_sequence<Ts...> lhs, task_t<ExecutionPolicy, U> rhs, std::index_sequence<Ids...>)
 	{
-		sequence<task_t<ExecutionPolicy, Ts>...> seq{ task(std::get<Ids>(lhs.sequence().actions()))... };
-		return sequence<task_t<ExecutionPolicy, Ts>..., task_t<ExecutionPolicy, U>>{ std::move(seq), rhs };
+		auto actions = std::move(lhs).sequence();
+		sequence<task_t<ExecutionPolicy, Ts>...> seq{ task(std::move(std::get<Ids>(actions.actions())))... };
+		return sequence<task_t<ExecutionPolicy, Ts>..., task_t<ExecutionPolicy, U>>{ std::move(seq), std::move(rhs) };
 	}
 
 	template<typename ExecutionPolicy, typename...Ts, typename U,
 		std::enable_if_t<is_kernel_v<U>, int> = 0>
 		auto operator | (kernel_sequence<Ts...> lhs, task_t<ExecutionPolicy, U> rhs)
 	{
-		return unpack_kernel_sequence(lhs, rhs, std::index_sequence_for<Ts...>{});
+		return unpack_kernel_sequence(std::move(lhs), std::move(rhs), std::index_sequence_for<Ts...>{});
+	}
+
+	template<typename ExecutionPolicy, typename T, typename...Us>
+	auto operator | (task_t<ExecutionPolicy, T> lhs, sequence<Us...>&& rhs)
+	{
+		return sequence<task_t<ExecutionPolicy, T>, Us...>{ sequence<task_t<ExecutionPolicy, T>>{ std::move(lhs) }, std::move(rhs) };
 	}
 
 	template<typename ExecutionPolicy, typename T, typename U, 
 		std::enable_if_t<!is_task_v<U>, int> = 0>
 	auto operator | (task_t<ExecutionPolicy, T> lhs, U rhs)
 	{
-		return sequence<task_t<ExecutionPolicy, T>, U>{lhs, rhs};
+		return sequence<task_t<ExecutionPolicy, T>, U>{ std::move(lhs), std::move(rhs) };
 	}
 
 	template<typename ExecutionPolicy, typename T, typename U,
 		std::enable_if_t<is_kernel_v<U>, int> = 0>
 		auto operator | (task_t<ExecutionPolicy, T> lhs, U rhs)
 	{
-		return sequence<task_t<ExecutionPolicy, T>, task_t<ExecutionPolicy, U>>{lhs, { rhs }};
+		return sequence<task_t<ExecutionPolicy, T>, task_t<ExecutionPolicy, U>>{ std::move(lhs), { std::move(rhs) } };
 	}
 
 	template<typename ExecutionPolicy, typename T, typename U,
 		std::enable_if_t<!is_kernel_v<U> && !is_task_v<U>, int> = 0>
 		auto operator | (task_t<ExecutionPolicy, T> lhs, U rhs)
 	{
-		return sequence<task_t<ExecutionPolicy, T>, U>{lhs, { rhs }};
+		return sequence<task_t<ExecutionPolicy, T>, U>{ std::move(lhs), { std::move(rhs) } };
 	}
 
 	template<typename ExecutionPolicy, typename T, typename U,
 		std::enable_if_t<is_kernel_v<T> && !is_sequence_v<T>, int> = 0>
 		auto operator | (T lhs, task_t<ExecutionPolicy, U> rhs)
 	{
-		return sequence<task_t<ExecutionPolicy, T>, task_t<ExecutionPolicy, U>>{ { lhs }, rhs};
+		return sequence<task_t<ExecutionPolicy, T>, task_t<ExecutionPolicy, U>>{ { std::move(lhs) }, std::move(rhs) };
 	}
 
 	template<typename ExecutionPolicy, typename T, typename U,
 		std::enable_if_t<!is_kernel_v<T> && !is_sequence_v<T> && !is_task_v<T>, int> = 0>
 		auto operator | (T lhs, task_t<ExecutionPolicy, U> rhs)
 	{
-		return sequence<T, task_t<ExecutionPolicy, U>>{ { lhs }, rhs};
+		return sequence<T, task_t<ExecutionPolicy, U>>{ { std::move(lhs) }, std::move(rhs) };
 	}
 
 	template<template <typename...> typename Sequence, typename...Actions, typename Action,
 		std::enable_if_t<is_sequence_v<Sequence<Actions...>> && !is_kernel_v<Action>, int> = 0>
 		auto operator | (Sequence<Actions...> && seq, Action action)
 	{
-		return sequence<Actions..., Action>{ std::move(seq), action };
+		return sequence<Actions..., Action>{ std::move(seq), std::move(action) };
 	}
 
 	template<template <typename...> typename Sequence, typename...Actions, typename Action,
 		std::enable_if_t<is_sequence_v<Sequence<Actions...>>&& is_kernel_v<Action>, int> = 0>
 		auto operator | (Sequence<Actions...> && seq, Action action)
 	{
-		return sequence<Actions..., task_t<distributed_execution_policy, Action>>{ std::move(seq), task(action) };
+		return sequence<Actions..., task_t<distributed_execution_policy, Action>>{ std::move(seq), task(std::move(action)) };
 	}
 }
 